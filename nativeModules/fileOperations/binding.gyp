@@ -4,8 +4,15 @@
       "target_name": "fileOperations",
       "sources": [
         "src/addon.cc",
+        "src/dir_handle.cpp",
         "src/file_ops.cpp",
-        "src/file_watcher.cpp"
+        "src/file_sync.cpp",
+        "src/file_watcher.cpp",
+        "src/fs_utils.cpp",
+        "src/hashing.cpp",
+        "src/io_control.cpp",
+        "src/io_scheduler.cpp",
+        "src/manifest.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -1,10 +1,18 @@
 #include <napi.h>
 
+#include "dir_handle.h"
 #include "file_ops.h"
+#include "file_sync.h"
 #include "file_watcher.h"
+#include "io_control.h"
+#include "manifest.h"
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    RegisterIoControl(env, exports);
     RegisterFileOperations(env, exports);
+    RegisterFileSync(env, exports);
+    RegisterDirHandle(env, exports);
+    RegisterManifest(env, exports);
     RegisterFileWatcher(env, exports);
     return exports;
 }
@@ -0,0 +1,541 @@
+#include "dir_handle.h"
+#include "file_ops.h"
+#include "fs_utils.h"
+
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#if __has_include(<linux/openat2.h>)
+#include <linux/openat2.h>
+#endif
+#endif
+#ifdef __APPLE__
+#include <stdio.h>
+#endif
+#endif
+
+namespace {
+
+enum class RenameMode { Replace, NoReplace, Exchange };
+
+// Relative paths may not be absolute or step outside the held directory. Paths that
+// modify the tree must also name an entry below the root: empty and "." segments are
+// rejected so that e.g. delete('.') cannot reach the root itself.
+bool IsContainedRelativePath(const std::string& rel, bool allowSelf) {
+    if (rel.empty()) return false;
+    if (rel[0] == '/' || rel[0] == '\\') return false;
+#ifdef _WIN32
+    if (rel.size() > 1 && rel[1] == ':') return false;
+#endif
+    size_t start = 0;
+    while (start <= rel.size()) {
+        size_t end = rel.find_first_of("/\\", start);
+        if (end == std::string::npos) end = rel.size();
+        if (rel.compare(start, end - start, "..") == 0) return false;
+        if (!allowSelf && (end == start || rel.compare(start, end - start, ".") == 0)) return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+#ifndef _WIN32
+// Opens the directory that holds the last component of rel without following any
+// symlink on the way, so a link inside the tree cannot redirect a modification outside
+// it. Returns a new descriptor (or -1 with errno set) and the final component in leaf;
+// the leaf itself is left to the caller, which must not follow it either.
+int OpenParentBeneath(int rootFd, const std::string& rel, std::string& leaf) {
+    size_t slash = rel.find_last_of('/');
+    leaf = slash == std::string::npos ? rel : rel.substr(slash + 1);
+    if (slash == std::string::npos) {
+        return fcntl(rootFd, F_DUPFD_CLOEXEC, 0);
+    }
+    std::string parent = rel.substr(0, slash);
+
+#if defined(__linux__) && defined(SYS_openat2) && defined(RESOLVE_BENEATH)
+    struct open_how how = {};
+    how.flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+    how.resolve = RESOLVE_BENEATH | RESOLVE_NO_SYMLINKS;
+    int resolved = static_cast<int>(syscall(SYS_openat2, rootFd, parent.c_str(), &how, sizeof(how)));
+    if (resolved >= 0 || errno != ENOSYS) {
+        return resolved;
+    }
+#endif
+
+    // Kernels without openat2: descend one component at a time, refusing links.
+    int fd = rootFd;
+    size_t start = 0;
+    while (start <= parent.size()) {
+        size_t end = parent.find('/', start);
+        if (end == std::string::npos) end = parent.size();
+        std::string name = parent.substr(start, end - start);
+        start = end + 1;
+        if (name.empty() || name == ".") continue;
+
+        int next = openat(fd, name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        int savedErr = errno;
+        if (fd != rootFd) close(fd);
+        errno = savedErr;
+        if (next < 0) return -1;
+        fd = next;
+    }
+    return fd == rootFd ? fcntl(rootFd, F_DUPFD_CLOEXEC, 0) : fd;
+}
+#endif
+
+class DirHandle : public Napi::ObjectWrap<DirHandle> {
+public:
+    static Napi::FunctionReference* constructor;
+
+    static Napi::Function Init(Napi::Env env) {
+        return DefineClass(env, "DirHandle", {
+            InstanceMethod("exists", &DirHandle::Exists),
+            InstanceMethod("read", &DirHandle::Read),
+            InstanceMethod("stat", &DirHandle::Stat),
+            InstanceMethod("delete", &DirHandle::Delete),
+            InstanceMethod("rename", &DirHandle::Rename),
+            InstanceMethod("list", &DirHandle::List),
+            InstanceMethod("close", &DirHandle::Close),
+        });
+    }
+
+    explicit DirHandle(const Napi::CallbackInfo& info) : Napi::ObjectWrap<DirHandle>(info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+            return;
+        }
+        std::string root = info[0].As<Napi::String>().Utf8Value();
+
+#ifdef _WIN32
+        root_ = Utf8ToWide(root);
+        while (!root_.empty() && (root_.back() == L'\\' || root_.back() == L'/')) {
+            root_.pop_back();
+        }
+        DWORD attrs = root_.empty() ? INVALID_FILE_ATTRIBUTES : GetFileAttributesW(root_.c_str());
+        if (attrs == INVALID_FILE_ATTRIBUTES || !(attrs & FILE_ATTRIBUTE_DIRECTORY)) {
+            ThrowFsError(env, "Failed to open directory");
+            return;
+        }
+        root_.push_back(L'\\');
+        open_ = true;
+#else
+        fd_ = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd_ < 0) {
+            ThrowFsError(env, "Failed to open directory");
+            return;
+        }
+#endif
+    }
+
+    ~DirHandle() override {
+        CloseHandleInternal();
+    }
+
+private:
+    void CloseHandleInternal() {
+#ifdef _WIN32
+        open_ = false;
+#else
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+#endif
+    }
+
+    bool EnsureOpen(Napi::Env env) {
+#ifdef _WIN32
+        bool isOpen = open_;
+#else
+        bool isOpen = fd_ >= 0;
+#endif
+        if (!isOpen) {
+            Napi::Error::New(env, "Directory handle is closed").ThrowAsJavaScriptException();
+        }
+        return isOpen;
+    }
+
+    bool GetRelPath(const Napi::CallbackInfo& info, size_t index, std::string& out, bool allowSelf = true) {
+        Napi::Env env = info.Env();
+        if (info.Length() <= index || !info[index].IsString()) {
+            Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+            return false;
+        }
+        out = info[index].As<Napi::String>().Utf8Value();
+        if (!IsContainedRelativePath(out, allowSelf)) {
+            Napi::TypeError::New(env, "Path must be relative to the directory handle").ThrowAsJavaScriptException();
+            return false;
+        }
+        return EnsureOpen(env);
+    }
+
+#ifdef _WIN32
+    std::wstring Resolve(const std::string& rel) const {
+        std::wstring wrel = Utf8ToWide(rel);
+        for (auto& ch : wrel) {
+            if (ch == L'/') ch = L'\\';
+        }
+        return root_ + wrel;
+    }
+
+    // True if every directory between the root and the last component of rel is a real
+    // directory rather than a junction or symlink that could lead outside the root.
+    bool ParentsAreReal(const std::string& rel) const {
+        std::wstring path = Resolve(rel);
+        size_t pos = root_.size();
+        for (;;) {
+            size_t sep = path.find(L'\\', pos);
+            if (sep == std::wstring::npos) return true;
+            DWORD attrs = GetFileAttributesW(path.substr(0, sep).c_str());
+            if (attrs == INVALID_FILE_ATTRIBUTES) return false;
+            if (attrs & FILE_ATTRIBUTE_REPARSE_POINT) {
+                SetLastError(ERROR_CANT_ACCESS_FILE);
+                return false;
+            }
+            pos = sep + 1;
+        }
+    }
+#endif
+
+    Napi::Value Exists(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string rel;
+        if (!GetRelPath(info, 0, rel)) return env.Null();
+
+#ifdef _WIN32
+        DWORD attrs = GetFileAttributesW(Resolve(rel).c_str());
+        return Napi::Boolean::New(env, attrs != INVALID_FILE_ATTRIBUTES);
+#else
+        struct stat st;
+        return Napi::Boolean::New(env, fstatat(fd_, rel.c_str(), &st, 0) == 0);
+#endif
+    }
+
+    Napi::Value Read(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string rel;
+        if (!GetRelPath(info, 0, rel)) return env.Null();
+
+#ifdef _WIN32
+        HANDLE h = CreateFileW(
+            Resolve(rel).c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        );
+        if (h == INVALID_HANDLE_VALUE) {
+            ThrowFsError(env, "Failed to open file for read");
+            return env.Null();
+        }
+        return ReadHandleToBuffer(env, h);
+#else
+        int fd = openat(fd_, rel.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            ThrowFsError(env, "Failed to open file for read");
+            return env.Null();
+        }
+        return ReadFdToBuffer(env, fd);
+#endif
+    }
+
+    Napi::Value Stat(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string rel;
+        if (!GetRelPath(info, 0, rel)) return env.Null();
+
+        double size = 0;
+        double mtimeMs = 0;
+        uint32_t mode = 0;
+        bool isDir = false;
+
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(Resolve(rel).c_str(), GetFileExInfoStandard, &data)) {
+            DWORD err = GetLastError();
+            if (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND) return env.Null();
+            ThrowFsError(env, "Failed to stat path");
+            return env.Null();
+        }
+        isDir = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        size = static_cast<double>((static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow);
+        ULARGE_INTEGER ft;
+        ft.LowPart = data.ftLastWriteTime.dwLowDateTime;
+        ft.HighPart = data.ftLastWriteTime.dwHighDateTime;
+        mtimeMs = (static_cast<double>(ft.QuadPart) - 116444736000000000.0) / 10000.0;
+        mode = data.dwFileAttributes;
+#else
+        struct stat st;
+        if (fstatat(fd_, rel.c_str(), &st, 0) != 0) {
+            if (errno == ENOENT || errno == ENOTDIR) return env.Null();
+            ThrowFsError(env, "Failed to stat path");
+            return env.Null();
+        }
+        isDir = S_ISDIR(st.st_mode);
+        size = static_cast<double>(st.st_size);
+#ifdef __APPLE__
+        mtimeMs = st.st_mtimespec.tv_sec * 1000.0 + st.st_mtimespec.tv_nsec / 1e6;
+#else
+        mtimeMs = st.st_mtim.tv_sec * 1000.0 + st.st_mtim.tv_nsec / 1e6;
+#endif
+        mode = static_cast<uint32_t>(st.st_mode);
+#endif
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("size", Napi::Number::New(env, size));
+        result.Set("mtimeMs", Napi::Number::New(env, mtimeMs));
+        result.Set("mode", Napi::Number::New(env, mode));
+        result.Set("isDirectory", Napi::Boolean::New(env, isDir));
+        result.Set("isFile", Napi::Boolean::New(env, !isDir));
+        return result;
+    }
+
+    Napi::Value Delete(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string rel;
+        if (!GetRelPath(info, 0, rel, false)) return env.Null();
+
+#ifdef _WIN32
+        if (!ParentsAreReal(rel)) {
+            ThrowFsError(env, "Failed to resolve path");
+            return env.Null();
+        }
+        std::wstring wpath = Resolve(rel);
+        DWORD attrs = GetFileAttributesW(wpath.c_str());
+        if (attrs == INVALID_FILE_ATTRIBUTES) {
+            ThrowFsError(env, "Path does not exist");
+            return env.Null();
+        }
+        // Junctions and directory symlinks are removed as links, never followed.
+        if ((attrs & FILE_ATTRIBUTE_DIRECTORY) && (attrs & FILE_ATTRIBUTE_REPARSE_POINT)) {
+            if (!RemoveDirectoryW(wpath.c_str())) {
+                ThrowFsError(env, "Failed to delete directory link");
+                return env.Null();
+            }
+        } else if (attrs & FILE_ATTRIBUTE_DIRECTORY) {
+            if (!RemoveDirectoryRecursiveW(wpath)) {
+                ThrowFsError(env, "Failed to delete directory");
+                return env.Null();
+            }
+        } else if (!DeleteFileW(wpath.c_str())) {
+            ThrowFsError(env, "Failed to delete file");
+            return env.Null();
+        }
+#else
+        std::string leaf;
+        int parentFd = OpenParentBeneath(fd_, rel, leaf);
+        if (parentFd < 0) {
+            ThrowFsError(env, "Failed to resolve path");
+            return env.Null();
+        }
+        const char* message = nullptr;
+        struct stat st;
+        if (fstatat(parentFd, leaf.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            message = "Path does not exist";
+        } else if (S_ISDIR(st.st_mode)) {
+            if (!RemoveTreeAt(parentFd, leaf.c_str())) message = "Failed to delete directory";
+        } else if (unlinkat(parentFd, leaf.c_str(), 0) != 0) {
+            message = "Failed to delete file";
+        }
+        int savedErr = errno;
+        close(parentFd);
+        errno = savedErr;
+        if (message) {
+            ThrowFsError(env, message);
+            return env.Null();
+        }
+#endif
+
+        return env.Undefined();
+    }
+
+    Napi::Value Rename(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string from;
+        std::string to;
+        if (!GetRelPath(info, 0, from, false) || !GetRelPath(info, 1, to, false)) return env.Null();
+
+        RenameMode mode = RenameMode::Replace;
+        if (info.Length() > 2 && info[2].IsString()) {
+            std::string name = info[2].As<Napi::String>().Utf8Value();
+            if (name == "noreplace") {
+                mode = RenameMode::NoReplace;
+            } else if (name == "exchange") {
+                mode = RenameMode::Exchange;
+            } else if (name != "replace") {
+                Napi::TypeError::New(env, "Rename mode must be 'replace', 'noreplace' or 'exchange'")
+                    .ThrowAsJavaScriptException();
+                return env.Null();
+            }
+        }
+
+#ifdef _WIN32
+        if (mode == RenameMode::Exchange) {
+            Napi::Error::New(env, "Atomic exchange is not supported on this platform").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (!ParentsAreReal(from) || !ParentsAreReal(to)) {
+            ThrowFsError(env, "Failed to resolve path");
+            return env.Null();
+        }
+        DWORD flags = mode == RenameMode::Replace ? MOVEFILE_REPLACE_EXISTING : 0;
+        if (!MoveFileExW(Resolve(from).c_str(), Resolve(to).c_str(), flags)) {
+            ThrowFsError(env, "Failed to rename file");
+            return env.Null();
+        }
+#else
+        std::string fromLeaf;
+        std::string toLeaf;
+        int fromFd = OpenParentBeneath(fd_, from, fromLeaf);
+        int toFd = fromFd < 0 ? -1 : OpenParentBeneath(fd_, to, toLeaf);
+        if (toFd < 0) {
+            int savedErr = errno;
+            if (fromFd >= 0) close(fromFd);
+            errno = savedErr;
+            ThrowFsError(env, "Failed to resolve path");
+            return env.Null();
+        }
+
+        int rc;
+        if (mode == RenameMode::Replace) {
+            rc = renameat(fromFd, fromLeaf.c_str(), toFd, toLeaf.c_str());
+        } else {
+#if defined(__linux__) && defined(SYS_renameat2)
+            // RENAME_NOREPLACE / RENAME_EXCHANGE from <linux/fs.h>.
+            unsigned int flags = mode == RenameMode::NoReplace ? 1u : 2u;
+            rc = static_cast<int>(syscall(SYS_renameat2, fromFd, fromLeaf.c_str(), toFd, toLeaf.c_str(), flags));
+#elif defined(__APPLE__)
+            unsigned int flags = mode == RenameMode::NoReplace ? RENAME_EXCL : RENAME_SWAP;
+            rc = renameatx_np(fromFd, fromLeaf.c_str(), toFd, toLeaf.c_str(), flags);
+#else
+            errno = ENOSYS;
+            rc = -1;
+#endif
+        }
+        int savedErr = errno;
+        close(fromFd);
+        close(toFd);
+        errno = savedErr;
+        if (rc != 0) {
+            ThrowFsError(env, "Failed to rename file");
+            return env.Null();
+        }
+#endif
+
+        return env.Undefined();
+    }
+
+    Napi::Value List(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string rel = ".";
+        if (info.Length() > 0 && !info[0].IsUndefined()) {
+            if (!GetRelPath(info, 0, rel)) return env.Null();
+        } else if (!EnsureOpen(env)) {
+            return env.Null();
+        }
+
+        Napi::Array result = Napi::Array::New(env);
+        uint32_t index = 0;
+        auto push = [&](const std::string& name, bool isDir) {
+            Napi::Object entry = Napi::Object::New(env);
+            entry.Set("name", Napi::String::New(env, name));
+            entry.Set("isDirectory", Napi::Boolean::New(env, isDir));
+            result.Set(index++, entry);
+        };
+
+#ifdef _WIN32
+        std::wstring dir = rel == "." ? root_ : Resolve(rel) + L"\\";
+        WIN32_FIND_DATAW findData;
+        HANDLE findHandle = FindFirstFileExW(
+            (dir + L"*").c_str(),
+            FindExInfoBasic,
+            &findData,
+            FindExSearchNameMatch,
+            nullptr,
+            FIND_FIRST_EX_LARGE_FETCH
+        );
+        if (findHandle == INVALID_HANDLE_VALUE) {
+            ThrowFsError(env, "Failed to list directory");
+            return env.Null();
+        }
+        do {
+            std::wstring fileName = findData.cFileName;
+            if (fileName == L"." || fileName == L"..") continue;
+            push(WideToUtf8(fileName), (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+        } while (FindNextFileW(findHandle, &findData));
+        FindClose(findHandle);
+#else
+        int fd = openat(fd_, rel.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            ThrowFsError(env, "Failed to list directory");
+            return env.Null();
+        }
+        DIR* dir = fdopendir(fd);
+        if (!dir) {
+            int savedErr = errno;
+            close(fd);
+            errno = savedErr;
+            ThrowFsError(env, "Failed to list directory");
+            return env.Null();
+        }
+        struct dirent* ent;
+        while ((ent = readdir(dir)) != nullptr) {
+            std::string fileName = ent->d_name;
+            if (fileName == "." || fileName == "..") continue;
+            bool isDir = ent->d_type == DT_DIR;
+            if (ent->d_type == DT_UNKNOWN) {
+                struct stat st;
+                isDir = fstatat(dirfd(dir), ent->d_name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+            }
+            push(fileName, isDir);
+        }
+        closedir(dir);
+#endif
+
+        return result;
+    }
+
+    Napi::Value Close(const Napi::CallbackInfo& info) {
+        CloseHandleInternal();
+        return info.Env().Undefined();
+    }
+
+#ifdef _WIN32
+    std::wstring root_;
+    bool open_ = false;
+#else
+    int fd_ = -1;
+#endif
+};
+
+Napi::FunctionReference* DirHandle::constructor = nullptr;
+
+Napi::Value OpenDirWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return DirHandle::constructor->New({ info[0] });
+}
+
+}  // namespace
+
+void RegisterDirHandle(Napi::Env env, Napi::Object exports) {
+    DirHandle::constructor = new Napi::FunctionReference(Napi::Persistent(DirHandle::Init(env)));
+    exports.Set("openDir", Napi::Function::New(env, OpenDirWrapped));
+}
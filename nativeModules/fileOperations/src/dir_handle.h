@@ -0,0 +1,8 @@
+#ifndef DIR_HANDLE_H
+#define DIR_HANDLE_H
+
+#include <napi.h>
+
+void RegisterDirHandle(Napi::Env env, Napi::Object exports);
+
+#endif
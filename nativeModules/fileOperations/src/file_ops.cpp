@@ -1,4 +1,6 @@
 #include "file_ops.h"
+#include "fs_utils.h"
+#include "io_control.h"
 
 #include <algorithm>
 #include <limits>
@@ -12,78 +14,11 @@
 #include <windows.h>
 #else
 #include <cerrno>
-#include <cstring>
-#include <dirent.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
 
-namespace {
-
-std::string GetLastErrorMessage() {
-#ifdef _WIN32
-    DWORD err = GetLastError();
-    if (err == 0) return std::string();
-
-    LPWSTR buf = nullptr;
-    DWORD len = FormatMessageW(
-        FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-        nullptr,
-        err,
-        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-        (LPWSTR)&buf,
-        0,
-        nullptr
-    );
-
-    if (len == 0 || buf == nullptr) {
-        return std::string("WinAPI error code: ") + std::to_string(err);
-    }
-
-    int size = WideCharToMultiByte(
-        CP_UTF8,
-        0,
-        buf,
-        static_cast<int>(len),
-        nullptr,
-        0,
-        nullptr,
-        nullptr
-    );
-
-    if (size <= 0) {
-        LocalFree(buf);
-        return std::string("WinAPI error code: ") + std::to_string(err);
-    }
-
-    std::string result(size, 0);
-    WideCharToMultiByte(
-        CP_UTF8,
-        0,
-        buf,
-        static_cast<int>(len),
-        &result[0],
-        size,
-        nullptr,
-        nullptr
-    );
-
-    LocalFree(buf);
-
-    while (!result.empty() && (result.back() == '\r' || result.back() == '\n')) {
-        result.pop_back();
-    }
-
-    return result;
-#else
-    int err = errno;
-    const char* msg = strerror(err);
-    if (!msg) return std::string("errno: ") + std::to_string(err);
-    return std::string(msg);
-#endif
-}
-
 void ThrowFsError(Napi::Env env, const std::string& prefix) {
     std::string msg = prefix;
     std::string osErr = GetLastErrorMessage();
@@ -95,172 +30,7 @@ void ThrowFsError(Napi::Env env, const std::string& prefix) {
 }
 
 #ifdef _WIN32
-std::wstring Utf8ToWide(const std::string& s) {
-    if (s.empty()) return std::wstring();
-    int size = MultiByteToWideChar(
-        CP_UTF8,
-        0,
-        s.c_str(),
-        static_cast<int>(s.size()),
-        nullptr,
-        0
-    );
-    if (size <= 0) {
-        return std::wstring();
-    }
-    std::wstring result(size, 0);
-    MultiByteToWideChar(
-        CP_UTF8,
-        0,
-        s.c_str(),
-        static_cast<int>(s.size()),
-        &result[0],
-        size
-    );
-    return result;
-}
-
-bool RemoveDirectoryRecursiveW(const std::wstring& path) {
-    WIN32_FIND_DATAW findData;
-    HANDLE findHandle = FindFirstFileW((path + L"\\*").c_str(), &findData);
-
-    if (findHandle == INVALID_HANDLE_VALUE) {
-        return false;
-    }
-
-    bool success = true;
-    do {
-        std::wstring fileName = findData.cFileName;
-        if (fileName == L"." || fileName == L"..") {
-            continue;
-        }
-
-        std::wstring fullPath = path + L"\\" + fileName;
-
-        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            if (!RemoveDirectoryRecursiveW(fullPath)) {
-                success = false;
-                break;
-            }
-        } else {
-            if (!DeleteFileW(fullPath.c_str())) {
-                success = false;
-                break;
-            }
-        }
-    } while (FindNextFileW(findHandle, &findData));
-
-    FindClose(findHandle);
-
-    if (success && !RemoveDirectoryW(path.c_str())) {
-        return false;
-    }
-
-    return success;
-}
-#else
-bool RemoveDirectoryRecursive(const std::string& path) {
-    DIR* dir = opendir(path.c_str());
-    if (!dir) {
-        return false;
-    }
-
-    bool success = true;
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string fileName = entry->d_name;
-        if (fileName == "." || fileName == "..") {
-            continue;
-        }
-
-        std::string fullPath = path + "/" + fileName;
-        struct stat st;
-
-        if (stat(fullPath.c_str(), &st) != 0) {
-            success = false;
-            break;
-        }
-
-        if (S_ISDIR(st.st_mode)) {
-            if (!RemoveDirectoryRecursive(fullPath)) {
-                success = false;
-                break;
-            }
-        } else {
-            if (unlink(fullPath.c_str()) != 0) {
-                success = false;
-                break;
-            }
-        }
-    }
-
-    closedir(dir);
-
-    if (success && rmdir(path.c_str()) != 0) {
-        return false;
-    }
-
-    return success;
-}
-#endif
-
-Napi::Value FileExistsWrapped(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
-        return env.Null();
-    }
-
-    std::string path = info[0].As<Napi::String>().Utf8Value();
-
-#ifdef _WIN32
-    std::wstring wpath = Utf8ToWide(path);
-    if (wpath.empty()) {
-        return Napi::Boolean::New(env, false);
-    }
-    DWORD attrs = GetFileAttributesW(wpath.c_str());
-    if (attrs == INVALID_FILE_ATTRIBUTES) {
-        return Napi::Boolean::New(env, false);
-    }
-    return Napi::Boolean::New(env, true);
-#else
-    struct stat st;
-    if (stat(path.c_str(), &st) == 0) {
-        return Napi::Boolean::New(env, true);
-    }
-    return Napi::Boolean::New(env, false);
-#endif
-}
-
-Napi::Value ReadFileWrapped(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
-        return env.Null();
-    }
-    std::string path = info[0].As<Napi::String>().Utf8Value();
-
-#ifdef _WIN32
-    std::wstring wpath = Utf8ToWide(path);
-    if (wpath.empty()) {
-        ThrowFsError(env, "Failed to convert path to wide string");
-        return env.Null();
-    }
-
-    HANDLE h = CreateFileW(
-        wpath.c_str(),
-        GENERIC_READ,
-        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-        nullptr,
-        OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL,
-        nullptr
-    );
-    if (h == INVALID_HANDLE_VALUE) {
-        ThrowFsError(env, "Failed to open file for read");
-        return env.Null();
-    }
-
+Napi::Value ReadHandleToBuffer(Napi::Env env, HANDLE h) {
     LARGE_INTEGER size;
     if (!GetFileSizeEx(h, &size)) {
         CloseHandle(h);
@@ -300,13 +70,9 @@ Napi::Value ReadFileWrapped(const Napi::CallbackInfo& info) {
 
     CloseHandle(h);
     return Napi::Buffer<uint8_t>::Copy(env, buf.data(), totalRead);
+}
 #else
-    int fd = open(path.c_str(), O_RDONLY);
-    if (fd < 0) {
-        ThrowFsError(env, "Failed to open file for read");
-        return env.Null();
-    }
-
+Napi::Value ReadFdToBuffer(Napi::Env env, int fd) {
     struct stat st;
     if (fstat(fd, &st) != 0) {
         int savedErr = errno;
@@ -355,6 +121,77 @@ Napi::Value ReadFileWrapped(const Napi::CallbackInfo& info) {
 
     close(fd);
     return Napi::Buffer<uint8_t>::Copy(env, buf.data(), totalRead);
+}
+#endif
+
+namespace {
+
+Napi::Value FileExistsWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+
+#ifdef _WIN32
+    std::wstring wpath = Utf8ToWide(path);
+    if (wpath.empty()) {
+        return Napi::Boolean::New(env, false);
+    }
+    DWORD attrs = GetFileAttributesW(wpath.c_str());
+    if (attrs == INVALID_FILE_ATTRIBUTES) {
+        return Napi::Boolean::New(env, false);
+    }
+    return Napi::Boolean::New(env, true);
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) {
+        return Napi::Boolean::New(env, true);
+    }
+    return Napi::Boolean::New(env, false);
+#endif
+}
+
+Napi::Value ReadFileWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+
+#ifdef _WIN32
+    std::wstring wpath = Utf8ToWide(path);
+    if (wpath.empty()) {
+        ThrowFsError(env, "Failed to convert path to wide string");
+        return env.Null();
+    }
+
+    HANDLE h = CreateFileW(
+        wpath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (h == INVALID_HANDLE_VALUE) {
+        ThrowFsError(env, "Failed to open file for read");
+        return env.Null();
+    }
+
+    return ReadHandleToBuffer(env, h);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ThrowFsError(env, "Failed to open file for read");
+        return env.Null();
+    }
+
+    return ReadFdToBuffer(env, fd);
 #endif
 }
 
@@ -380,7 +217,13 @@ Napi::Value DeleteFileWrapped(const Napi::CallbackInfo& info) {
         return env.Null();
     }
 
-    if (attrs & FILE_ATTRIBUTE_DIRECTORY) {
+    if ((attrs & FILE_ATTRIBUTE_DIRECTORY) && (attrs & FILE_ATTRIBUTE_REPARSE_POINT)) {
+        // A junction or directory symlink is unlinked, never followed into its target.
+        if (!RemoveDirectoryW(wpath.c_str())) {
+            ThrowFsError(env, "Failed to delete directory");
+            return env.Null();
+        }
+    } else if (attrs & FILE_ATTRIBUTE_DIRECTORY) {
         if (!RemoveDirectoryRecursiveW(wpath)) {
             ThrowFsError(env, "Failed to delete directory");
             return env.Null();
@@ -393,7 +236,7 @@ Napi::Value DeleteFileWrapped(const Napi::CallbackInfo& info) {
     }
 #else
     struct stat st;
-    if (stat(path.c_str(), &st) != 0) {
+    if (lstat(path.c_str(), &st) != 0) {
         ThrowFsError(env, "Path does not exist");
         return env.Null();
     }
@@ -451,80 +294,6 @@ Napi::Value RenameFileWrapped(const Napi::CallbackInfo& info) {
     return env.Undefined();
 }
 
-#ifndef _WIN32
-bool CopyFilePosix(const std::string& src, const std::string& dst, std::string& errMsg) {
-    int inFd = open(src.c_str(), O_RDONLY);
-    if (inFd < 0) {
-        errMsg = GetLastErrorMessage();
-        return false;
-    }
-
-    struct stat st;
-    if (fstat(inFd, &st) != 0) {
-        int savedErr = errno;
-        close(inFd);
-        errno = savedErr;
-        errMsg = GetLastErrorMessage();
-        return false;
-    }
-
-    mode_t mode = st.st_mode & 0777;
-    int outFd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
-    if (outFd < 0) {
-        int savedErr = errno;
-        close(inFd);
-        errno = savedErr;
-        errMsg = GetLastErrorMessage();
-        return false;
-    }
-
-    const size_t bufSize = 65536;
-    std::vector<char> buf(bufSize);
-
-    while (true) {
-        ssize_t r = read(inFd, buf.data(), bufSize);
-        if (r < 0) {
-            int savedErr = errno;
-            close(inFd);
-            close(outFd);
-            errno = savedErr;
-            errMsg = GetLastErrorMessage();
-            return false;
-        }
-        if (r == 0) break;
-
-        ssize_t off = 0;
-        while (off < r) {
-            ssize_t w = write(outFd, buf.data() + off, r - off);
-            if (w < 0) {
-                int savedErr = errno;
-                close(inFd);
-                close(outFd);
-                errno = savedErr;
-                errMsg = GetLastErrorMessage();
-                return false;
-            }
-            off += w;
-        }
-    }
-
-    if (close(inFd) != 0) {
-        int savedErr = errno;
-        close(outFd);
-        errno = savedErr;
-        errMsg = GetLastErrorMessage();
-        return false;
-    }
-
-    if (close(outFd) != 0) {
-        errMsg = GetLastErrorMessage();
-        return false;
-    }
-
-    return true;
-}
-#endif
-
 Napi::Value MoveFileWrapped(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
@@ -563,7 +332,7 @@ Napi::Value MoveFileWrapped(const Napi::CallbackInfo& info) {
     }
 
     std::string msg;
-    if (!CopyFilePosix(src, dst, msg)) {
+    if (!CopyFilePosix(src, dst, false, msg)) {
         Napi::Error::New(env, std::string("Failed to move file (copy phase): ") + msg).ThrowAsJavaScriptException();
         return env.Null();
     }
@@ -577,6 +346,176 @@ Napi::Value MoveFileWrapped(const Napi::CallbackInfo& info) {
     return env.Undefined();
 }
 
+// Runs a single file operation on the I/O scheduler's threads once its priority class
+// has a free slot, and settles a Promise with the result.
+class ScheduledOpWorker : public ScheduledWorker {
+public:
+    ScheduledOpWorker(Napi::Env env, const char* name, IoContext io)
+        : ScheduledWorker(env, name, std::move(io)),
+          deferred_(Napi::Promise::Deferred::New(env)) {}
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    virtual bool Perform(std::string& errMsg) = 0;
+    virtual Napi::Value Result(Napi::Env env) { return env.Undefined(); }
+
+    void Execute() override {
+        std::string errMsg;
+        if (!Perform(errMsg)) {
+            SetError(errMsg);
+        }
+    }
+
+    void OnOK() override {
+        deferred_.Resolve(Result(Env()));
+    }
+
+    void OnError(const Napi::Error& e) override {
+        deferred_.Reject(e.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+};
+
+class FileExistsWorker : public ScheduledOpWorker {
+public:
+    FileExistsWorker(Napi::Env env, std::string path, IoContext io)
+        : ScheduledOpWorker(env, "FileExists", std::move(io)), path_(std::move(path)) {}
+
+protected:
+    bool Perform(std::string&) override {
+        exists_ = PathExists(path_);
+        return true;
+    }
+
+    Napi::Value Result(Napi::Env env) override { return Napi::Boolean::New(env, exists_); }
+
+private:
+    std::string path_;
+    bool exists_ = false;
+};
+
+class ReadFileWorker : public ScheduledOpWorker {
+public:
+    ReadFileWorker(Napi::Env env, std::string path, IoContext io)
+        : ScheduledOpWorker(env, "ReadFile", std::move(io)), path_(std::move(path)) {}
+
+protected:
+    bool Perform(std::string& errMsg) override {
+        std::string err;
+        auto sink = [this](const uint8_t* data, size_t len) { data_.insert(data_.end(), data, data + len); };
+        if (!ReadFileChunks(path_, sink, err, &Io())) {
+            errMsg = "Failed to read file: " + err;
+            return false;
+        }
+        return true;
+    }
+
+    Napi::Value Result(Napi::Env env) override {
+        return Napi::Buffer<uint8_t>::Copy(env, data_.data(), data_.size());
+    }
+
+private:
+    std::string path_;
+    std::vector<uint8_t> data_;
+};
+
+class DeleteFileWorker : public ScheduledOpWorker {
+public:
+    DeleteFileWorker(Napi::Env env, std::string path, IoContext io)
+        : ScheduledOpWorker(env, "DeleteFile", std::move(io)), path_(std::move(path)) {}
+
+protected:
+    bool Perform(std::string& errMsg) override {
+        if (!PathExists(path_)) {
+            errMsg = "Path does not exist: " + GetLastErrorMessage();
+            return false;
+        }
+        if (!RemovePath(path_, &Io())) {
+            errMsg = "Failed to delete path: " + GetLastErrorMessage();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::string path_;
+};
+
+class MoveFileWorker : public ScheduledOpWorker {
+public:
+    MoveFileWorker(Napi::Env env, std::string src, std::string dst, IoContext io)
+        : ScheduledOpWorker(env, "MoveFile", std::move(io)), src_(std::move(src)), dst_(std::move(dst)) {}
+
+protected:
+    bool Perform(std::string& errMsg) override {
+        std::string err;
+        if (!MovePath(src_, dst_, err, &Io())) {
+            errMsg = "Failed to move file: " + err;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::string src_;
+    std::string dst_;
+};
+
+template <typename Worker, typename... Paths>
+Napi::Value QueueScheduled(const Napi::CallbackInfo& info, size_t optionsIndex, IoPriority priority, Paths... paths) {
+    Napi::Env env = info.Env();
+    IoContext io;
+    io.priority = priority;
+    if (info.Length() > optionsIndex && !ParseIoOptions(env, info[optionsIndex], io)) {
+        return env.Null();
+    }
+    auto* worker = new Worker(env, std::move(paths)..., std::move(io));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+Napi::Value FileExistsAsyncWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return QueueScheduled<FileExistsWorker>(info, 1, IoPriority::Interactive, info[0].As<Napi::String>().Utf8Value());
+}
+
+Napi::Value ReadFileAsyncWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return QueueScheduled<ReadFileWorker>(info, 1, IoPriority::Interactive, info[0].As<Napi::String>().Utf8Value());
+}
+
+Napi::Value DeleteFileAsyncWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return QueueScheduled<DeleteFileWorker>(info, 1, IoPriority::Normal, info[0].As<Napi::String>().Utf8Value());
+}
+
+Napi::Value MoveFileAsyncWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Source and destination path must be strings").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return QueueScheduled<MoveFileWorker>(
+        info, 2, IoPriority::Normal, info[0].As<Napi::String>().Utf8Value(), info[1].As<Napi::String>().Utf8Value()
+    );
+}
+
 }  // namespace
 
 void RegisterFileOperations(Napi::Env env, Napi::Object exports) {
@@ -585,5 +524,9 @@ void RegisterFileOperations(Napi::Env env, Napi::Object exports) {
     exports.Set("deleteFile", Napi::Function::New(env, DeleteFileWrapped));
     exports.Set("renameFile", Napi::Function::New(env, RenameFileWrapped));
     exports.Set("moveFile", Napi::Function::New(env, MoveFileWrapped));
+    exports.Set("fileExistsAsync", Napi::Function::New(env, FileExistsAsyncWrapped));
+    exports.Set("readFileAsync", Napi::Function::New(env, ReadFileAsyncWrapped));
+    exports.Set("deleteFileAsync", Napi::Function::New(env, DeleteFileAsyncWrapped));
+    exports.Set("moveFileAsync", Napi::Function::New(env, MoveFileAsyncWrapped));
 }
 
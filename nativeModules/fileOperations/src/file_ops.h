@@ -3,6 +3,17 @@
 
 #include <napi.h>
 
+#include <string>
+
 void RegisterFileOperations(Napi::Env env, Napi::Object exports);
 
+void ThrowFsError(Napi::Env env, const std::string& prefix);
+
+// Reads the whole file behind an open handle into a Buffer and closes the handle.
+#ifdef _WIN32
+Napi::Value ReadHandleToBuffer(Napi::Env env, void* h);
+#else
+Napi::Value ReadFdToBuffer(Napi::Env env, int fd);
+#endif
+
 #endif
@@ -0,0 +1,455 @@
+#include "file_sync.h"
+#include "fs_utils.h"
+#include "io_control.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Changed files are first copied into this directory at the destination root and only
+// moved into place once every copy succeeded, so a failed or cancelled sync leaves the
+// destination as it was. Living on the same volume keeps the final move a rename.
+constexpr const char* kStageDir = ".psync-stage";
+
+struct SyncOptions {
+    bool deleteExtraneous = false;
+    bool verify = false;
+    size_t workers = 0;
+    IoContext io;
+};
+
+enum class SyncPhase { Scan, Copy, Commit, Delete };
+
+const char* PhaseName(SyncPhase phase) {
+    switch (phase) {
+        case SyncPhase::Scan: return "scan";
+        case SyncPhase::Copy: return "copy";
+        case SyncPhase::Commit: return "commit";
+        case SyncPhase::Delete: return "delete";
+    }
+    return "unknown";
+}
+
+struct SyncProgress {
+    SyncPhase phase = SyncPhase::Scan;
+    uint64_t done = 0;
+    uint64_t total = 0;
+    uint64_t bytes = 0;
+};
+
+struct SyncStats {
+    uint64_t copied = 0;
+    uint64_t unchanged = 0;
+    uint64_t deleted = 0;
+    uint64_t dirsCreated = 0;
+    uint64_t bytesCopied = 0;
+};
+
+struct SyncJob {
+    std::string path;
+    uint64_t size = 0;
+    bool compare = false;
+    bool replaceDir = false;
+    bool unchanged = false;
+};
+
+struct DirJob {
+    std::string path;
+    bool replaceFile = false;
+};
+
+// The whole sync holds one slot of its priority class; the copy fan-out inside it only
+// adds threads for slots of that class that are free, and is paced by its bandwidth budget.
+class SyncTreeWorker : public ScheduledWorker {
+public:
+    SyncTreeWorker(Napi::Env env, std::string src, std::string dst, SyncOptions options, Napi::Function onProgress)
+        : ScheduledWorker(env, "SyncTree", options.io),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          src_(std::move(src)),
+          dst_(std::move(dst)),
+          options_(options) {
+        if (!onProgress.IsEmpty()) {
+            onProgress_ = Napi::Persistent(onProgress);
+        }
+    }
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        std::string errMsg;
+        Report(SyncPhase::Scan, 0, 0, 0);
+
+        std::vector<TreeEntry> srcEntries;
+        if (!WalkTree(src_, srcEntries, errMsg)) {
+            SetError("Failed to read source directory: " + errMsg);
+            return;
+        }
+
+        bool dstIsDir = false;
+        bool dstExists = PathExists(dst_, &dstIsDir);
+        if (dstExists && !dstIsDir) {
+            SetError("Destination exists and is not a directory");
+            return;
+        }
+        for (const auto& entry : srcEntries) {
+            if (PathKey(entry.path) == PathKey(kStageDir)) {
+                SetError(std::string("Source contains reserved entry '") + kStageDir + "'");
+                return;
+            }
+        }
+
+        std::vector<TreeEntry> dstEntries;
+        if (dstExists && !WalkTree(dst_, dstEntries, errMsg)) {
+            SetError("Failed to read destination directory: " + errMsg);
+            return;
+        }
+        // A staging directory left behind by an interrupted run is not part of the tree.
+        const std::string stageKey = PathKey(kStageDir);
+        dstEntries.erase(
+            std::remove_if(
+                dstEntries.begin(),
+                dstEntries.end(),
+                [&stageKey](const TreeEntry& entry) {
+                    std::string key = PathKey(entry.path);
+                    return key == stageKey || key.compare(0, stageKey.size() + 1, stageKey + "/") == 0;
+                }
+            ),
+            dstEntries.end()
+        );
+        if (options_.io.Cancelled()) {
+            SetError(kIoCancelledMessage);
+            return;
+        }
+
+        std::unordered_map<std::string, const TreeEntry*> dstIndex;
+        dstIndex.reserve(dstEntries.size());
+        for (const auto& entry : dstEntries) {
+            dstIndex.emplace(PathKey(entry.path), &entry);
+        }
+
+        std::unordered_map<std::string, bool> srcIsDir;
+        srcIsDir.reserve(srcEntries.size());
+        std::vector<DirJob> dirs;
+        std::vector<SyncJob> jobs;
+
+        for (const auto& entry : srcEntries) {
+            std::string key = PathKey(entry.path);
+            srcIsDir.emplace(key, entry.isDir);
+
+            auto it = dstIndex.find(key);
+            const TreeEntry* existing = it == dstIndex.end() ? nullptr : it->second;
+
+            if (entry.isDir) {
+                if (existing && existing->isDir) continue;
+                DirJob dir;
+                dir.path = entry.path;
+                dir.replaceFile = existing != nullptr;
+                dirs.push_back(std::move(dir));
+                continue;
+            }
+
+            SyncJob job;
+            job.path = entry.path;
+            job.size = entry.size;
+            if (existing && existing->isDir) {
+                job.replaceDir = true;
+            } else if (existing && existing->size == entry.size) {
+                if (options_.verify) {
+                    job.compare = true;
+                } else if (existing->mtimeNs == entry.mtimeNs) {
+                    ++stats_.unchanged;
+                    continue;
+                }
+            }
+            jobs.push_back(std::move(job));
+        }
+
+        if (!dstExists) {
+            if (!CreateDirectories(dst_)) {
+                SetError("Failed to create destination directory: " + GetLastErrorMessage());
+                return;
+            }
+            createdDst_ = true;
+        }
+
+        stageDir_ = JoinPath(dst_, kStageDir);
+        if (PathExists(stageDir_) && !RemovePath(stageDir_)) {
+            SetError("Failed to remove stale staging directory: " + GetLastErrorMessage());
+            DiscardStaged();
+            return;
+        }
+        if (!CreateDirectories(stageDir_)) {
+            SetError("Failed to create staging directory: " + GetLastErrorMessage());
+            DiscardStaged();
+            return;
+        }
+
+        if (!StageFiles(jobs)) {
+            DiscardStaged();
+            return;
+        }
+
+        // Last point where an abort leaves the destination untouched.
+        if (options_.io.Cancelled()) {
+            SetError(kIoCancelledMessage);
+            DiscardStaged();
+            return;
+        }
+
+        bool committed = CommitFiles(dirs, jobs);
+        // Whatever was not moved into place is garbage now, even on success.
+        RemovePath(stageDir_);
+        if (!committed) {
+            return;
+        }
+
+        if (options_.deleteExtraneous) {
+            DeleteExtraneous(dstEntries, srcIsDir);
+        }
+    }
+
+    void OnProgress(Napi::Env env) {
+        SyncProgress data;
+        {
+            std::lock_guard<std::mutex> lock(progressMutex_);
+            data = progress_;
+            progressPosted_ = false;
+        }
+        if (onProgress_.IsEmpty()) return;
+        Napi::HandleScope scope(env);
+        Napi::Object event = Napi::Object::New(env);
+        event.Set("phase", Napi::String::New(env, PhaseName(data.phase)));
+        event.Set("done", Napi::Number::New(env, static_cast<double>(data.done)));
+        event.Set("total", Napi::Number::New(env, static_cast<double>(data.total)));
+        event.Set("bytes", Napi::Number::New(env, static_cast<double>(data.bytes)));
+        try {
+            onProgress_.Call({ event });
+        } catch (const Napi::Error&) {
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("copied", Napi::Number::New(env, static_cast<double>(stats_.copied)));
+        result.Set("unchanged", Napi::Number::New(env, static_cast<double>(stats_.unchanged)));
+        result.Set("deleted", Napi::Number::New(env, static_cast<double>(stats_.deleted)));
+        result.Set("dirsCreated", Napi::Number::New(env, static_cast<double>(stats_.dirsCreated)));
+        result.Set("bytesCopied", Napi::Number::New(env, static_cast<double>(stats_.bytesCopied)));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& e) override {
+        deferred_.Reject(e.Value());
+    }
+
+private:
+    // Keeps only the latest progress; at most one delivery is in flight at a time.
+    void Report(SyncPhase phase, uint64_t done, uint64_t total, uint64_t bytes) {
+        if (onProgress_.IsEmpty()) return;
+        std::lock_guard<std::mutex> lock(progressMutex_);
+        progress_.phase = phase;
+        progress_.done = done;
+        progress_.total = total;
+        progress_.bytes = bytes;
+        if (progressPosted_) return;
+        progressPosted_ = true;
+        Post([this](Napi::Env env) { OnProgress(env); });
+    }
+
+    bool StageFiles(std::vector<SyncJob>& jobs) {
+        std::atomic<uint64_t> done{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<bool> failed{false};
+        std::mutex errorMutex;
+        std::string firstError;
+
+        const IoContext& io = options_.io;
+        auto fail = [&](const std::string& message) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!failed.exchange(true)) firstError = io.Cancelled() ? std::string(kIoCancelledMessage) : message;
+        };
+
+        size_t workers = options_.workers > 0 ? options_.workers : DefaultWorkerCount();
+        IoFanOut fanOut(io, std::min(workers, jobs.size()));
+        ParallelFor(jobs.size(), fanOut.Workers(), [&](size_t i) {
+            if (failed.load()) return;
+            if (io.Cancelled()) {
+                fail(kIoCancelledMessage);
+                return;
+            }
+            SyncJob& job = jobs[i];
+            std::string srcPath = JoinPath(src_, job.path);
+            std::string dstPath = JoinPath(dst_, job.path);
+            std::string err;
+
+            if (job.compare) {
+                job.unchanged = FilesEqual(srcPath, dstPath, err, &io);
+                if (!job.unchanged && !err.empty()) {
+                    fail("Failed to compare '" + job.path + "': " + err);
+                    return;
+                }
+            }
+
+            if (!job.unchanged) {
+                if (!CopyFileFast(srcPath, StagePath(i), err, &io)) {
+                    fail("Failed to copy '" + job.path + "': " + err);
+                    return;
+                }
+                bytes += job.size;
+            }
+
+            Report(SyncPhase::Copy, ++done, jobs.size(), bytes.load());
+        });
+
+        if (failed.load()) {
+            SetError(firstError);
+            return false;
+        }
+        return true;
+    }
+
+    std::string StagePath(size_t index) const {
+        return JoinPath(stageDir_, std::to_string(index));
+    }
+
+    // Directories go first (parents before children, as they come from WalkTree) so
+    // every staged file has a parent to land in.
+    bool CommitFiles(const std::vector<DirJob>& dirs, const std::vector<SyncJob>& jobs) {
+        for (const auto& dir : dirs) {
+            std::string target = JoinPath(dst_, dir.path);
+            if (dir.replaceFile && !RemovePath(target)) {
+                SetError("Failed to remove file in place of directory '" + dir.path + "': " + GetLastErrorMessage());
+                return false;
+            }
+            if (!CreateDirectories(target)) {
+                SetError("Failed to create directory '" + dir.path + "': " + GetLastErrorMessage());
+                return false;
+            }
+            ++stats_.dirsCreated;
+        }
+
+        uint64_t done = 0;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            const SyncJob& job = jobs[i];
+            if (job.unchanged) {
+                ++stats_.unchanged;
+                continue;
+            }
+            std::string dstPath = JoinPath(dst_, job.path);
+            if (job.replaceDir && !RemovePath(dstPath)) {
+                SetError("Failed to remove directory in place of file '" + job.path + "': " + GetLastErrorMessage());
+                return false;
+            }
+            if (!RenameReplace(StagePath(i), dstPath)) {
+                SetError("Failed to replace '" + job.path + "': " + GetLastErrorMessage());
+                return false;
+            }
+            ++stats_.copied;
+            stats_.bytesCopied += job.size;
+            Report(SyncPhase::Commit, ++done, jobs.size(), stats_.bytesCopied);
+        }
+        return true;
+    }
+
+    void DiscardStaged() {
+        if (!stageDir_.empty()) {
+            RemovePath(stageDir_);
+        }
+        if (createdDst_) {
+            RemovePath(dst_);
+        }
+    }
+
+    void DeleteExtraneous(
+        const std::vector<TreeEntry>& dstEntries,
+        const std::unordered_map<std::string, bool>& srcIsDir
+    ) {
+        // Entries are ordered so a directory is followed by its descendants; once a
+        // directory is gone (or replaced by a file) everything under it can be skipped.
+        std::string removedPrefix;
+        for (const auto& entry : dstEntries) {
+            if (!removedPrefix.empty() && entry.path.compare(0, removedPrefix.size(), removedPrefix) == 0) {
+                continue;
+            }
+            removedPrefix.clear();
+
+            auto it = srcIsDir.find(PathKey(entry.path));
+            if (it != srcIsDir.end()) {
+                if (entry.isDir && !it->second) removedPrefix = entry.path + "/";
+                continue;
+            }
+
+            if (!RemovePath(JoinPath(dst_, entry.path), &options_.io)) {
+                SetError(
+                    options_.io.Cancelled() ? std::string(kIoCancelledMessage)
+                                            : "Failed to delete '" + entry.path + "': " + GetLastErrorMessage()
+                );
+                return;
+            }
+            ++stats_.deleted;
+            if (entry.isDir) removedPrefix = entry.path + "/";
+            Report(SyncPhase::Delete, stats_.deleted, 0, stats_.bytesCopied);
+        }
+    }
+
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference onProgress_;
+    std::string src_;
+    std::string dst_;
+    SyncOptions options_;
+    SyncStats stats_;
+    std::string stageDir_;
+    bool createdDst_ = false;
+    std::mutex progressMutex_;
+    SyncProgress progress_;
+    bool progressPosted_ = false;
+};
+
+Napi::Value SyncTreeWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Source and destination path must be strings").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    std::string src = info[0].As<Napi::String>().Utf8Value();
+    std::string dst = info[1].As<Napi::String>().Utf8Value();
+
+    SyncOptions options;
+    options.io.priority = IoPriority::Background;
+    Napi::Function onProgress;
+    if (info.Length() > 2 && !ParseIoOptions(env, info[2], options.io)) {
+        return env.Null();
+    }
+    if (info.Length() > 2 && info[2].IsObject()) {
+        Napi::Object opts = info[2].As<Napi::Object>();
+        options.deleteExtraneous = opts.Get("delete").ToBoolean().Value();
+        options.verify = opts.Get("verify").ToBoolean().Value();
+        Napi::Value workers = opts.Get("workers");
+        if (workers.IsNumber()) {
+            options.workers = static_cast<size_t>(std::max(1, workers.As<Napi::Number>().Int32Value()));
+        }
+        Napi::Value callback = opts.Get("onProgress");
+        if (callback.IsFunction()) {
+            onProgress = callback.As<Napi::Function>();
+        }
+    }
+
+    auto* worker = new SyncTreeWorker(env, std::move(src), std::move(dst), options, onProgress);
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+}  // namespace
+
+void RegisterFileSync(Napi::Env env, Napi::Object exports) {
+    exports.Set("syncTree", Napi::Function::New(env, SyncTreeWrapped));
+}
@@ -0,0 +1,8 @@
+#ifndef FILE_SYNC_H
+#define FILE_SYNC_H
+
+#include <napi.h>
+
+void RegisterFileSync(Napi::Env env, Napi::Object exports);
+
+#endif
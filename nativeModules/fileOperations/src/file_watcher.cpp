@@ -2,73 +2,382 @@
 
 #include <cctype>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace {
 
+namespace fs = std::filesystem;
+
+using FileTimes = std::unordered_map<std::string, fs::file_time_type>;
+
+// A cached listing is trusted only when the directory mtime is unchanged and was already
+// this old when the listing was taken, so entries added within the same timestamp tick
+// are not missed on filesystems with coarse mtimes.
+constexpr auto kRacyWindow = std::chrono::seconds(2);
+
+constexpr char kIndexMagic[4] = { 'P', 'S', 'W', 'I' };
+constexpr uint32_t kIndexVersion = 1;
+
+struct DirRecord {
+    fs::file_time_type mtime;
+    fs::file_time_type listedAt;
+    std::vector<fs::path> files;
+    std::vector<fs::path> subdirs;
+};
+
+using DirIndex = std::unordered_map<std::string, DirRecord>;
+
+struct WatchState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::thread thread;
+
+    ~WatchState() {
+        if (thread.joinable()) thread.detach();
+    }
+};
+
 inline std::string ToLower(std::string s) {
     for (auto& ch : s) ch = static_cast<char>(::tolower(static_cast<unsigned char>(ch)));
     return s;
 }
 
-std::unordered_map<std::string, std::filesystem::file_time_type> SnapshotDir(const std::filesystem::path& root) {
-    namespace fs = std::filesystem;
-    std::unordered_map<std::string, fs::file_time_type> out;
-    std::error_code ec;
-    fs::directory_options opts = fs::directory_options::skip_permission_denied;
-    for (fs::recursive_directory_iterator it(root, opts, ec), end; it != end; it.increment(ec)) {
-        if (ec) {
-            ec.clear();
-            continue;
-        }
-        const fs::directory_entry& entry = *it;
-        if (!entry.is_regular_file(ec)) {
-            if (ec) ec.clear();
-            continue;
-        }
+std::string ToKey(const fs::path& p) {
 #ifdef _WIN32
-        auto u8ext = entry.path().extension().u8string();
-        std::string ext;
-        ext.reserve(u8ext.size());
-        for (char8_t c : u8ext) ext.push_back(static_cast<char>(c));
-        ext = ToLower(std::move(ext));
+    auto u8key = p.generic_u8string();
+    std::string key;
+    key.reserve(u8key.size());
+    for (char8_t c : u8key) key.push_back(static_cast<char>(c));
+    return key;
 #else
-        std::string ext = ToLower(entry.path().extension().string());
+    return p.string();
 #endif
-        if (ext == ".js" || ext == ".css") {
-            auto ft = entry.last_write_time(ec);
-            if (ec) { ec.clear(); continue; }
+}
+
+fs::path FromKey(const std::string& key) {
 #ifdef _WIN32
-            auto u8key = entry.path().generic_u8string();
-            std::string key;
-            key.reserve(u8key.size());
-            for (char8_t c : u8key) key.push_back(static_cast<char>(c));
+    std::u8string u8path;
+    u8path.reserve(key.size());
+    for (unsigned char c : key) u8path.push_back(static_cast<char8_t>(c));
+    return fs::path(u8path);
 #else
-            std::string key = entry.path().string();
+    return fs::path(key);
 #endif
-            out.emplace(std::move(key), ft);
+}
+
+bool IsWatchedFile(const fs::path& p) {
+#ifdef _WIN32
+    auto u8ext = p.extension().u8string();
+    std::string ext;
+    ext.reserve(u8ext.size());
+    for (char8_t c : u8ext) ext.push_back(static_cast<char>(c));
+    ext = ToLower(std::move(ext));
+#else
+    std::string ext = ToLower(p.extension().string());
+#endif
+    return ext == ".js" || ext == ".css";
+}
+
+bool IsSettled(const DirRecord& record) {
+    return record.mtime + kRacyWindow < record.listedAt;
+}
+
+void ScanDir(const fs::path& dir, const DirIndex& cached, DirIndex& next, FileTimes& out) {
+    std::error_code ec;
+    auto mtime = fs::last_write_time(dir, ec);
+    if (ec) return;
+
+    std::string key = ToKey(dir);
+    DirRecord record;
+    auto it = cached.find(key);
+    if (it != cached.end() && it->second.mtime == mtime && IsSettled(it->second)) {
+        record = it->second;
+    } else {
+        record.mtime = mtime;
+        record.listedAt = fs::file_time_type::clock::now();
+        fs::directory_iterator iter(dir, fs::directory_options::skip_permission_denied, ec);
+        if (ec) return;
+        for (fs::directory_iterator end; iter != end; iter.increment(ec)) {
+            if (ec) break;
+            const fs::directory_entry& entry = *iter;
+            std::error_code entryEc;
+            if (entry.is_directory(entryEc) && !entry.is_symlink(entryEc)) {
+                record.subdirs.push_back(entry.path().filename());
+            } else if (entry.is_regular_file(entryEc) && IsWatchedFile(entry.path())) {
+                record.files.push_back(entry.path().filename());
+            }
+        }
+    }
+
+    for (const auto& name : record.files) {
+        fs::path file = dir / name;
+        auto ft = fs::last_write_time(file, ec);
+        if (ec) {
+            ec.clear();
+            continue;
         }
+        out.emplace(ToKey(file), ft);
+    }
+    for (const auto& name : record.subdirs) {
+        ScanDir(dir / name, cached, next, out);
     }
+
+    next.emplace(std::move(key), std::move(record));
+}
+
+// Rebuilds the snapshot, re-listing only directories whose mtime moved since `index` was taken.
+FileTimes SnapshotDir(const fs::path& root, DirIndex& index) {
+    FileTimes out;
+    DirIndex next;
+    ScanDir(root, index, next, out);
+    index.swap(next);
     return out;
 }
 
-void Watcher(const Napi::CallbackInfo& info) {
+void PutU32(std::string& buf, uint32_t v) {
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void PutI64(std::string& buf, int64_t v) {
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+void PutStr(std::string& buf, const std::string& s) {
+    PutU32(buf, static_cast<uint32_t>(s.size()));
+    buf.append(s);
+}
+
+class IndexReader {
+public:
+    IndexReader(const std::string& data, size_t offset) : data_(data), pos_(offset) {}
+
+    bool U32(uint32_t& v) { return Raw(&v, sizeof(v)); }
+    bool I64(int64_t& v) { return Raw(&v, sizeof(v)); }
+    bool Str(std::string& s) {
+        uint32_t len;
+        if (!U32(len) || data_.size() - pos_ < len) return false;
+        s.assign(data_, pos_, len);
+        pos_ += len;
+        return true;
+    }
+    bool Time(fs::file_time_type& t) {
+        int64_t count;
+        if (!I64(count)) return false;
+        t = fs::file_time_type(fs::file_time_type::duration(count));
+        return true;
+    }
+    bool AtEnd() const { return pos_ == data_.size(); }
+
+private:
+    bool Raw(void* out, size_t len) {
+        if (data_.size() - pos_ < len) return false;
+        std::memcpy(out, data_.data() + pos_, len);
+        pos_ += len;
+        return true;
+    }
+
+    const std::string& data_;
+    size_t pos_;
+};
+
+// Layout (host byte order): magic, version, sizeof(rep), clock period, root,
+// then per directory: path, mtime, listedAt, files (name, mtime), subdir names.
+void SaveIndex(const fs::path& indexPath, const fs::path& root, const DirIndex& index, const FileTimes& files) {
+    using Period = fs::file_time_type::period;
+    std::string buf(kIndexMagic, sizeof(kIndexMagic));
+    PutU32(buf, kIndexVersion);
+    PutU32(buf, static_cast<uint32_t>(sizeof(fs::file_time_type::rep)));
+    PutI64(buf, static_cast<int64_t>(Period::num));
+    PutI64(buf, static_cast<int64_t>(Period::den));
+    PutStr(buf, ToKey(root));
+    PutU32(buf, static_cast<uint32_t>(index.size()));
+    for (const auto& kv : index) {
+        const DirRecord& record = kv.second;
+        PutStr(buf, kv.first);
+        PutI64(buf, static_cast<int64_t>(record.mtime.time_since_epoch().count()));
+        PutI64(buf, static_cast<int64_t>(record.listedAt.time_since_epoch().count()));
+        std::vector<std::pair<std::string, int64_t>> present;
+        for (const auto& name : record.files) {
+            auto it = files.find(ToKey(FromKey(kv.first) / name));
+            if (it == files.end()) continue;
+            present.emplace_back(ToKey(name), static_cast<int64_t>(it->second.time_since_epoch().count()));
+        }
+        PutU32(buf, static_cast<uint32_t>(present.size()));
+        for (const auto& file : present) {
+            PutStr(buf, file.first);
+            PutI64(buf, file.second);
+        }
+        PutU32(buf, static_cast<uint32_t>(record.subdirs.size()));
+        for (const auto& name : record.subdirs) {
+            PutStr(buf, ToKey(name));
+        }
+    }
+
+    std::error_code ec;
+    fs::path tmpPath = indexPath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream outFile(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!outFile) return;
+        outFile.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!outFile) {
+            outFile.close();
+            fs::remove(tmpPath, ec);
+            return;
+        }
+    }
+    fs::rename(tmpPath, indexPath, ec);
+    if (ec) fs::remove(tmpPath, ec);
+}
+
+// Returns false (leaving outputs empty) when the file is missing, truncated, from another
+// version or clock, or was written for a different root.
+bool LoadIndex(const fs::path& indexPath, const fs::path& root, DirIndex& index, FileTimes& files) {
+    using Period = fs::file_time_type::period;
+    std::ifstream inFile(indexPath, std::ios::binary);
+    if (!inFile) return false;
+    std::string data((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(kIndexMagic) || std::memcmp(data.data(), kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        return false;
+    }
+    IndexReader reader(data, sizeof(kIndexMagic));
+
+    uint32_t version, repSize, dirCount;
+    int64_t num, den;
+    std::string rootKey;
+    if (!reader.U32(version) || version != kIndexVersion) return false;
+    if (!reader.U32(repSize) || repSize != sizeof(fs::file_time_type::rep)) return false;
+    if (!reader.I64(num) || !reader.I64(den) || num != Period::num || den != Period::den) return false;
+    if (!reader.Str(rootKey) || rootKey != ToKey(root)) return false;
+    if (!reader.U32(dirCount)) return false;
+
+    DirIndex loaded;
+    FileTimes loadedFiles;
+    for (uint32_t d = 0; d < dirCount; ++d) {
+        std::string dirKey;
+        DirRecord record;
+        uint32_t fileCount, subdirCount;
+        if (!reader.Str(dirKey) || !reader.Time(record.mtime) || !reader.Time(record.listedAt) || !reader.U32(fileCount)) {
+            return false;
+        }
+        fs::path dirPath = FromKey(dirKey);
+        for (uint32_t f = 0; f < fileCount; ++f) {
+            std::string name;
+            fs::file_time_type mtime;
+            if (!reader.Str(name) || !reader.Time(mtime)) return false;
+            fs::path namePath = FromKey(name);
+            loadedFiles.emplace(ToKey(dirPath / namePath), mtime);
+            record.files.push_back(std::move(namePath));
+        }
+        if (!reader.U32(subdirCount)) return false;
+        for (uint32_t s = 0; s < subdirCount; ++s) {
+            std::string name;
+            if (!reader.Str(name)) return false;
+            record.subdirs.push_back(FromKey(name));
+        }
+        loaded.emplace(std::move(dirKey), std::move(record));
+    }
+    if (!reader.AtEnd()) return false;
+
+    index.swap(loaded);
+    files.swap(loadedFiles);
+    return true;
+}
+
+void Emit(const Napi::ThreadSafeFunction& tsfn, const std::string& event, const std::string& file) {
+    napi_status status = tsfn.BlockingCall(
+        [file, event](Napi::Env env, Napi::Function callback) {
+            callback.Call({
+                Napi::String::New(env, event),
+                Napi::String::New(env, file)
+            });
+        }
+    );
+    (void)status;
+}
+
+void EmitDiff(const Napi::ThreadSafeFunction& tsfn, const FileTimes& prev, const FileTimes& cur) {
+    for (const auto& kv : cur) {
+        auto it = prev.find(kv.first);
+        if (it == prev.end()) {
+            Emit(tsfn, "add", kv.first);
+        } else if (kv.second != it->second) {
+            Emit(tsfn, "change", kv.first);
+        }
+    }
+    for (const auto& kv : prev) {
+        if (cur.find(kv.first) == cur.end()) {
+            Emit(tsfn, "unlink", kv.first);
+        }
+    }
+}
+
+void Watcher(const fs::path& fsPath, const fs::path& indexPath, int interval, Napi::ThreadSafeFunction tsfn,
+             std::shared_ptr<WatchState> state) {
+    DirIndex index;
+    FileTimes persisted;
+    bool restored = !indexPath.empty() && LoadIndex(indexPath, fsPath, index, persisted);
+
+    auto prev = SnapshotDir(fsPath, index);
+    // Changes made while the app was closed are reported as the first batch.
+    if (restored) {
+        EmitDiff(tsfn, persisted, prev);
+    }
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->cv.wait_for(lock, std::chrono::milliseconds(interval), [&] { return state->stopping; })) {
+                break;
+            }
+        }
+        auto cur = SnapshotDir(fsPath, index);
+        EmitDiff(tsfn, prev, cur);
+        prev.swap(cur);
+    }
+
+    if (!indexPath.empty()) {
+        SaveIndex(indexPath, fsPath, index, prev);
+    }
+    tsfn.Release();
+}
+
+Napi::Value Watch(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     if (info.Length() < 3 ||
         !info[0].IsString() ||
         !info[1].IsNumber() ||
         !info[2].IsFunction()) {
-        Napi::TypeError::New(env, "Expected (path: string, intervalMs: number, callback: function)")
+        Napi::TypeError::New(env, "Expected (path: string, intervalMs: number, callback: function, options?: object)")
             .ThrowAsJavaScriptException();
-        return;
+        return env.Null();
     }
     std::string pathUtf8 = info[0].As<Napi::String>().Utf8Value();
     int interval = info[1].As<Napi::Number>().Int32Value();
     Napi::Function jsCallback = info[2].As<Napi::Function>();
+
+    fs::path indexPath;
+    if (info.Length() > 3 && info[3].IsObject()) {
+        Napi::Value indexValue = info[3].As<Napi::Object>().Get("indexPath");
+        if (indexValue.IsString()) {
+            indexPath = FromKey(indexValue.As<Napi::String>().Utf8Value());
+        }
+    }
+
     auto tsfn = Napi::ThreadSafeFunction::New(
         env,
         jsCallback,
@@ -76,71 +385,26 @@ void Watcher(const Napi::CallbackInfo& info) {
         0,
         1
     );
-#ifdef _WIN32
-    std::u8string u8path;
-    u8path.reserve(pathUtf8.size());
-    for (unsigned char c : pathUtf8) u8path.push_back(static_cast<char8_t>(c));
-    std::filesystem::path fsPath(u8path);
-#else
-    std::filesystem::path fsPath(pathUtf8);
-#endif
-    std::thread([fsPath, interval, tsfn]() mutable {
-        namespace fs = std::filesystem;
-        auto prev = SnapshotDir(fsPath);
-        for (;;) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(interval));
-            auto cur = SnapshotDir(fsPath);
-            for (const auto& kv : cur) {
-                const auto& file = kv.first;
-                const auto& mtime = kv.second;
-                auto it = prev.find(file);
-                if (it == prev.end()) {
-                    std::string event = "add";
-                    napi_status status = tsfn.BlockingCall(
-                        [file, event](Napi::Env env, Napi::Function callback) {
-                            callback.Call({
-                                Napi::String::New(env, event),
-                                Napi::String::New(env, file)
-                            });
-                        }
-                    );
-                    (void)status;
-                } else if (mtime != it->second) {
-                    std::string event = "change";
-                    napi_status status = tsfn.BlockingCall(
-                        [file, event](Napi::Env env, Napi::Function callback) {
-                            callback.Call({
-                                Napi::String::New(env, event),
-                                Napi::String::New(env, file)
-                            });
-                        }
-                    );
-                    (void)status;
-                }
-            }
-            for (const auto& kv : prev) {
-                const auto& file = kv.first;
-                if (cur.find(file) == cur.end()) {
-                    std::string event = "unlink";
-                    napi_status status = tsfn.BlockingCall(
-                        [file, event](Napi::Env env, Napi::Function callback) {
-                            callback.Call({
-                                Napi::String::New(env, event),
-                                Napi::String::New(env, file)
-                            });
-                        }
-                    );
-                    (void)status;
-                }
-            }
-            prev.swap(cur);
+    fs::path fsPath = FromKey(pathUtf8);
+
+    auto state = std::make_shared<WatchState>();
+    state->thread = std::thread(Watcher, fsPath, indexPath, interval, tsfn, state);
+
+    // Stopping wakes the poll loop, persists the index (when configured) and waits for the thread.
+    return Napi::Function::New(env, [state](const Napi::CallbackInfo& stopInfo) -> Napi::Value {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->stopping) return stopInfo.Env().Undefined();
+            state->stopping = true;
         }
-    }).detach();
+        state->cv.notify_all();
+        if (state->thread.joinable()) state->thread.join();
+        return stopInfo.Env().Undefined();
+    }, "stop");
 }
 
 }  // namespace
 
 void RegisterFileWatcher(Napi::Env env, Napi::Object exports) {
-    exports.Set("watch", Napi::Function::New(env, Watcher));
+    exports.Set("watch", Napi::Function::New(env, Watch));
 }
-
@@ -0,0 +1,951 @@
+#include "fs_utils.h"
+#include "io_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#ifdef __APPLE__
+#include <copyfile.h>
+#endif
+#endif
+
+#if !defined(_WIN32)
+#ifdef __APPLE__
+#define ST_ATIM(st) (st).st_atimespec
+#define ST_MTIM(st) (st).st_mtimespec
+#else
+#define ST_ATIM(st) (st).st_atim
+#define ST_MTIM(st) (st).st_mtim
+#endif
+#endif
+
+namespace {
+
+// Sets the platform "cancelled" error and returns true when io has been cancelled.
+bool CancelledNow(const IoContext* io) {
+    if (!io || !io->Cancelled()) return false;
+#ifdef _WIN32
+    SetLastError(ERROR_CANCELLED);
+#else
+    errno = ECANCELED;
+#endif
+    return true;
+}
+
+#ifdef _WIN32
+constexpr char kNativeSeparator = '\\';
+
+// FILETIME counts 100ns ticks since 1601-01-01.
+constexpr int64_t kFileTimeUnixEpoch = 116444736000000000LL;
+
+int64_t FileTimeToUnixNs(const FILETIME& ft) {
+    ULARGE_INTEGER v;
+    v.LowPart = ft.dwLowDateTime;
+    v.HighPart = ft.dwHighDateTime;
+    return (static_cast<int64_t>(v.QuadPart) - kFileTimeUnixEpoch) * 100;
+}
+
+struct CopyProgressState {
+    const IoContext* io;
+    LONGLONG transferred;
+};
+
+DWORD CALLBACK ScheduledCopyProgress(
+    LARGE_INTEGER,
+    LARGE_INTEGER transferred,
+    LARGE_INTEGER,
+    LARGE_INTEGER,
+    DWORD,
+    DWORD,
+    HANDLE,
+    HANDLE,
+    LPVOID data
+) {
+    auto* state = static_cast<CopyProgressState*>(data);
+    LONGLONG delta = transferred.QuadPart - state->transferred;
+    state->transferred = transferred.QuadPart;
+    if (state->io->Cancelled() || (delta > 0 && !state->io->Throttle(static_cast<size_t>(delta)))) {
+        return PROGRESS_CANCEL;
+    }
+    return PROGRESS_CONTINUE;
+}
+
+bool WalkDirWin(const std::wstring& dir, const std::string& prefix, std::vector<TreeEntry>& out, std::string& errMsg) {
+    WIN32_FIND_DATAW findData;
+    HANDLE findHandle = FindFirstFileExW(
+        (dir + L"\\*").c_str(),
+        FindExInfoBasic,
+        &findData,
+        FindExSearchNameMatch,
+        nullptr,
+        FIND_FIRST_EX_LARGE_FETCH
+    );
+    if (findHandle == INVALID_HANDLE_VALUE) {
+        DWORD err = GetLastError();
+        if (!prefix.empty() && (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND)) {
+            return true;
+        }
+        errMsg = prefix.empty() ? GetLastErrorMessage() : prefix + ": " + GetLastErrorMessage();
+        return false;
+    }
+
+    std::vector<std::pair<std::wstring, std::string>> subdirs;
+    do {
+        std::wstring fileName = findData.cFileName;
+        if (fileName == L"." || fileName == L"..") {
+            continue;
+        }
+        if (findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) {
+            continue;
+        }
+
+        std::string name = WideToUtf8(fileName);
+        TreeEntry entry;
+        entry.path = prefix.empty() ? name : prefix + "/" + name;
+        entry.isDir = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        entry.size = entry.isDir
+            ? 0
+            : (static_cast<uint64_t>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow;
+        entry.mtimeNs = FileTimeToUnixNs(findData.ftLastWriteTime);
+        entry.mode = findData.dwFileAttributes;
+        if (entry.isDir) {
+            subdirs.emplace_back(dir + L"\\" + fileName, entry.path);
+        }
+        out.push_back(std::move(entry));
+    } while (FindNextFileW(findHandle, &findData));
+
+    if (GetLastError() != ERROR_NO_MORE_FILES) {
+        errMsg = prefix.empty() ? GetLastErrorMessage() : prefix + ": " + GetLastErrorMessage();
+        FindClose(findHandle);
+        return false;
+    }
+    FindClose(findHandle);
+
+    for (const auto& sub : subdirs) {
+        if (!WalkDirWin(sub.first, sub.second, out, errMsg)) {
+            return false;
+        }
+    }
+    return true;
+}
+#else
+constexpr char kNativeSeparator = '/';
+
+void CloseKeepErrno(int fd) {
+    int savedErr = errno;
+    close(fd);
+    errno = savedErr;
+}
+
+// Takes ownership of dirFd.
+bool WalkDirPosix(int dirFd, const std::string& prefix, std::vector<TreeEntry>& out, std::string& errMsg) {
+    auto fail = [&](const std::string& path) {
+        errMsg = path.empty() ? GetLastErrorMessage() : path + ": " + GetLastErrorMessage();
+        return false;
+    };
+
+    DIR* dir = fdopendir(dirFd);
+    if (!dir) {
+        CloseKeepErrno(dirFd);
+        return fail(prefix);
+    }
+
+    std::vector<std::pair<std::string, std::string>> subdirs;
+    struct dirent* ent;
+    for (;;) {
+        errno = 0;
+        ent = readdir(dir);
+        if (!ent) {
+            if (errno != 0) {
+                bool ok = fail(prefix);
+                closedir(dir);
+                return ok;
+            }
+            break;
+        }
+        std::string fileName = ent->d_name;
+        if (fileName == "." || fileName == "..") {
+            continue;
+        }
+
+        std::string entryPath = prefix.empty() ? fileName : prefix + "/" + fileName;
+        struct stat st;
+        if (fstatat(dirfd(dir), ent->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            if (errno == ENOENT) continue;
+            bool ok = fail(entryPath);
+            closedir(dir);
+            return ok;
+        }
+        if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode)) {
+            continue;
+        }
+
+        TreeEntry entry;
+        entry.path = std::move(entryPath);
+        entry.isDir = S_ISDIR(st.st_mode);
+        entry.size = entry.isDir ? 0 : static_cast<uint64_t>(st.st_size);
+        entry.mtimeNs = static_cast<int64_t>(ST_MTIM(st).tv_sec) * 1000000000LL + ST_MTIM(st).tv_nsec;
+        entry.mode = static_cast<uint32_t>(st.st_mode & 07777);
+        if (entry.isDir) {
+            subdirs.emplace_back(fileName, entry.path);
+        }
+        out.push_back(std::move(entry));
+    }
+
+    for (const auto& sub : subdirs) {
+        int fd = openat(dirfd(dir), sub.first.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno == ENOENT) continue;
+            bool ok = fail(sub.second);
+            closedir(dir);
+            return ok;
+        }
+        if (!WalkDirPosix(fd, sub.second, out, errMsg)) {
+            closedir(dir);
+            return false;
+        }
+    }
+
+    closedir(dir);
+    return true;
+}
+
+bool CopyFdData(int inFd, int outFd, const IoContext* io) {
+#if defined(__linux__) && defined(SYS_copy_file_range)
+    // In-kernel copy (reflinks on btrfs/xfs); falls back to read/write where unsupported.
+    // Scheduled copies go in 1 MiB steps so cancellation and throttling stay responsive.
+    const size_t step = io ? (1 << 20) : (1 << 30);
+    for (;;) {
+        if (CancelledNow(io)) return false;
+        ssize_t n = syscall(SYS_copy_file_range, inFd, nullptr, outFd, nullptr, step, 0);
+        if (n > 0) {
+            if (io && !io->Throttle(static_cast<size_t>(n))) {
+                CancelledNow(io);
+                return false;
+            }
+            continue;
+        }
+        if (n == 0) return true;
+        if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP || errno == EPERM) {
+            break;
+        }
+        return false;
+    }
+#elif defined(__APPLE__)
+    // fcopyfile cannot be interrupted, so scheduled copies use the chunked loop below.
+    if (!io && fcopyfile(inFd, outFd, nullptr, COPYFILE_DATA) == 0) {
+        return true;
+    }
+    if (lseek(inFd, 0, SEEK_SET) < 0 || lseek(outFd, 0, SEEK_SET) < 0 || ftruncate(outFd, 0) != 0) {
+        return false;
+    }
+#endif
+
+    const size_t bufSize = 65536;
+    std::vector<char> buf(bufSize);
+
+    while (true) {
+        if (CancelledNow(io)) return false;
+        ssize_t r = read(inFd, buf.data(), bufSize);
+        if (r < 0) {
+            return false;
+        }
+        if (r == 0) break;
+        if (io && !io->Throttle(static_cast<size_t>(r))) {
+            CancelledNow(io);
+            return false;
+        }
+
+        ssize_t off = 0;
+        while (off < r) {
+            ssize_t w = write(outFd, buf.data() + off, r - off);
+            if (w < 0) {
+                return false;
+            }
+            off += w;
+        }
+    }
+    return true;
+}
+#endif
+
+}  // namespace
+
+bool ComparePaths(const std::string& l, const std::string& r) {
+    return std::lexicographical_compare(
+        l.begin(), l.end(), r.begin(), r.end(),
+        [](char a, char b) {
+            unsigned char ua = a == '/' ? 0 : static_cast<unsigned char>(a);
+            unsigned char ub = b == '/' ? 0 : static_cast<unsigned char>(b);
+            return ua < ub;
+        }
+    );
+}
+
+std::string GetLastErrorMessage() {
+#ifdef _WIN32
+    DWORD err = GetLastError();
+    if (err == 0) return std::string();
+
+    LPWSTR buf = nullptr;
+    DWORD len = FormatMessageW(
+        FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+        nullptr,
+        err,
+        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+        (LPWSTR)&buf,
+        0,
+        nullptr
+    );
+
+    if (len == 0 || buf == nullptr) {
+        return std::string("WinAPI error code: ") + std::to_string(err);
+    }
+
+    int size = WideCharToMultiByte(
+        CP_UTF8,
+        0,
+        buf,
+        static_cast<int>(len),
+        nullptr,
+        0,
+        nullptr,
+        nullptr
+    );
+
+    if (size <= 0) {
+        LocalFree(buf);
+        return std::string("WinAPI error code: ") + std::to_string(err);
+    }
+
+    std::string result(size, 0);
+    WideCharToMultiByte(
+        CP_UTF8,
+        0,
+        buf,
+        static_cast<int>(len),
+        &result[0],
+        size,
+        nullptr,
+        nullptr
+    );
+
+    LocalFree(buf);
+
+    while (!result.empty() && (result.back() == '\r' || result.back() == '\n')) {
+        result.pop_back();
+    }
+
+    return result;
+#else
+    int err = errno;
+    const char* msg = strerror(err);
+    if (!msg) return std::string("errno: ") + std::to_string(err);
+    return std::string(msg);
+#endif
+}
+
+#ifdef _WIN32
+std::wstring Utf8ToWide(const std::string& s) {
+    if (s.empty()) return std::wstring();
+    int size = MultiByteToWideChar(
+        CP_UTF8,
+        0,
+        s.c_str(),
+        static_cast<int>(s.size()),
+        nullptr,
+        0
+    );
+    if (size <= 0) {
+        return std::wstring();
+    }
+    std::wstring result(size, 0);
+    MultiByteToWideChar(
+        CP_UTF8,
+        0,
+        s.c_str(),
+        static_cast<int>(s.size()),
+        &result[0],
+        size
+    );
+    return result;
+}
+
+std::string WideToUtf8(const std::wstring& s) {
+    if (s.empty()) return std::string();
+    int size = WideCharToMultiByte(
+        CP_UTF8,
+        0,
+        s.c_str(),
+        static_cast<int>(s.size()),
+        nullptr,
+        0,
+        nullptr,
+        nullptr
+    );
+    if (size <= 0) {
+        return std::string();
+    }
+    std::string result(size, 0);
+    WideCharToMultiByte(
+        CP_UTF8,
+        0,
+        s.c_str(),
+        static_cast<int>(s.size()),
+        &result[0],
+        size,
+        nullptr,
+        nullptr
+    );
+    return result;
+}
+
+bool RemoveDirectoryRecursiveW(const std::wstring& path, const IoContext* io) {
+    WIN32_FIND_DATAW findData;
+    HANDLE findHandle = FindFirstFileW((path + L"\\*").c_str(), &findData);
+
+    if (findHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    bool success = true;
+    do {
+        std::wstring fileName = findData.cFileName;
+        if (fileName == L"." || fileName == L"..") {
+            continue;
+        }
+
+        if (CancelledNow(io)) {
+            success = false;
+            break;
+        }
+
+        std::wstring fullPath = path + L"\\" + fileName;
+
+        if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && (findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+            // Junctions and directory symlinks are unlinked, not followed into their target.
+            if (!RemoveDirectoryW(fullPath.c_str())) {
+                success = false;
+                break;
+            }
+        } else if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (!RemoveDirectoryRecursiveW(fullPath, io)) {
+                success = false;
+                break;
+            }
+        } else {
+            if (!DeleteFileW(fullPath.c_str())) {
+                success = false;
+                break;
+            }
+        }
+    } while (FindNextFileW(findHandle, &findData));
+
+    DWORD savedErr = GetLastError();
+    FindClose(findHandle);
+    SetLastError(savedErr);
+
+    if (success && !RemoveDirectoryW(path.c_str())) {
+        return false;
+    }
+
+    return success;
+}
+#else
+bool RemoveDirectoryRecursive(const std::string& path, const IoContext* io) {
+    return RemoveTreeAt(AT_FDCWD, path.c_str(), io);
+}
+
+bool RemoveTreeAt(int dirFd, const char* name, const IoContext* io) {
+    int fd = openat(dirFd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    DIR* dir = fdopendir(fd);
+    if (!dir) {
+        CloseKeepErrno(fd);
+        return false;
+    }
+
+    bool success = true;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        if (CancelledNow(io)) {
+            success = false;
+            break;
+        }
+
+        struct stat st;
+        if (fstatat(dirfd(dir), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            success = false;
+            break;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            if (!RemoveTreeAt(dirfd(dir), entry->d_name, io)) {
+                success = false;
+                break;
+            }
+        } else if (unlinkat(dirfd(dir), entry->d_name, 0) != 0) {
+            success = false;
+            break;
+        }
+    }
+
+    int savedErr = errno;
+    closedir(dir);
+    errno = savedErr;
+
+    if (success && unlinkat(dirFd, name, AT_REMOVEDIR) != 0) {
+        return false;
+    }
+
+    return success;
+}
+
+bool CopyFilePosix(const std::string& src, const std::string& dst, bool preserveMetadata, std::string& errMsg, const IoContext* io) {
+    int inFd = open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inFd < 0) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(inFd, &st) != 0) {
+        CloseKeepErrno(inFd);
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+
+    mode_t mode = st.st_mode & 0777;
+    int outFd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    if (outFd < 0) {
+        CloseKeepErrno(inFd);
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+
+    bool ok = CopyFdData(inFd, outFd, io);
+    if (ok && preserveMetadata) {
+        struct timespec times[2] = { ST_ATIM(st), ST_MTIM(st) };
+        ok = fchmod(outFd, mode) == 0 && futimens(outFd, times) == 0;
+    }
+    if (!ok) {
+        CloseKeepErrno(inFd);
+        CloseKeepErrno(outFd);
+        errMsg = (io && io->Cancelled()) ? kIoCancelledMessage : GetLastErrorMessage();
+        return false;
+    }
+
+    if (close(inFd) != 0) {
+        CloseKeepErrno(outFd);
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+
+    if (close(outFd) != 0) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+std::string JoinPath(const std::string& root, const std::string& rel) {
+    if (rel.empty()) return root;
+    std::string result = root;
+    if (!result.empty() && result.back() != '/' && result.back() != kNativeSeparator) {
+        result.push_back(kNativeSeparator);
+    }
+    for (char c : rel) {
+        result.push_back(c == '/' ? kNativeSeparator : c);
+    }
+    return result;
+}
+
+std::string PathKey(const std::string& rel) {
+#if defined(_WIN32) || defined(__APPLE__)
+    std::string key = rel;
+    for (auto& ch : key) ch = static_cast<char>(::tolower(static_cast<unsigned char>(ch)));
+    return key;
+#else
+    return rel;
+#endif
+}
+
+bool PathExists(const std::string& path, bool* isDir) {
+#ifdef _WIN32
+    std::wstring wpath = Utf8ToWide(path);
+    if (wpath.empty()) return false;
+    DWORD attrs = GetFileAttributesW(wpath.c_str());
+    if (attrs == INVALID_FILE_ATTRIBUTES) return false;
+    if (isDir) *isDir = (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    return true;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    if (isDir) *isDir = S_ISDIR(st.st_mode);
+    return true;
+#endif
+}
+
+bool CreateDirectories(const std::string& path) {
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (path[i] != '/' && path[i] != kNativeSeparator) continue;
+        std::string prefix = path.substr(0, i);
+#ifdef _WIN32
+        CreateDirectoryW(Utf8ToWide(prefix).c_str(), nullptr);
+#else
+        mkdir(prefix.c_str(), 0777);
+#endif
+    }
+#ifdef _WIN32
+    CreateDirectoryW(Utf8ToWide(path).c_str(), nullptr);
+#else
+    mkdir(path.c_str(), 0777);
+#endif
+    bool isDir = false;
+    return PathExists(path, &isDir) && isDir;
+}
+
+bool RemovePath(const std::string& path, const IoContext* io) {
+#ifdef _WIN32
+    std::wstring wpath = Utf8ToWide(path);
+    if (wpath.empty()) return false;
+    DWORD attrs = GetFileAttributesW(wpath.c_str());
+    if (attrs == INVALID_FILE_ATTRIBUTES) return false;
+    if ((attrs & FILE_ATTRIBUTE_DIRECTORY) && !(attrs & FILE_ATTRIBUTE_REPARSE_POINT)) {
+        return RemoveDirectoryRecursiveW(wpath, io);
+    }
+    if (attrs & FILE_ATTRIBUTE_DIRECTORY) {
+        return RemoveDirectoryW(wpath.c_str()) != 0;
+    }
+    return DeleteFileW(wpath.c_str()) != 0;
+#else
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0) return false;
+    if (S_ISDIR(st.st_mode)) {
+        return RemoveDirectoryRecursive(path, io);
+    }
+    return unlink(path.c_str()) == 0;
+#endif
+}
+
+bool RenameReplace(const std::string& src, const std::string& dst) {
+#ifdef _WIN32
+    std::wstring wsrc = Utf8ToWide(src);
+    std::wstring wdst = Utf8ToWide(dst);
+    if (wsrc.empty() || wdst.empty()) return false;
+    return MoveFileExW(wsrc.c_str(), wdst.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(src.c_str(), dst.c_str()) == 0;
+#endif
+}
+
+bool CopyFileFast(const std::string& src, const std::string& dst, std::string& errMsg, const IoContext* io) {
+#ifdef _WIN32
+    std::wstring wsrc = Utf8ToWide(src);
+    std::wstring wdst = Utf8ToWide(dst);
+    if (wsrc.empty() || wdst.empty()) {
+        errMsg = "Failed to convert path to wide string";
+        return false;
+    }
+    // CopyFileExW keeps attributes and the last write time.
+    CopyProgressState progress = { io, 0 };
+    LPPROGRESS_ROUTINE routine = io ? ScheduledCopyProgress : nullptr;
+    if (!CopyFileExW(wsrc.c_str(), wdst.c_str(), routine, io ? &progress : nullptr, nullptr, 0)) {
+        errMsg = (io && io->Cancelled()) ? kIoCancelledMessage : GetLastErrorMessage();
+        return false;
+    }
+    return true;
+#else
+    return CopyFilePosix(src, dst, true, errMsg, io);
+#endif
+}
+
+bool MovePath(const std::string& src, const std::string& dst, std::string& errMsg, const IoContext* io) {
+#ifdef _WIN32
+    std::wstring wsrc = Utf8ToWide(src);
+    std::wstring wdst = Utf8ToWide(dst);
+    if (wsrc.empty() || wdst.empty()) {
+        errMsg = "Failed to convert path to wide string";
+        return false;
+    }
+    CopyProgressState progress = { io, 0 };
+    LPPROGRESS_ROUTINE routine = io ? ScheduledCopyProgress : nullptr;
+    if (!MoveFileWithProgressW(
+            wsrc.c_str(), wdst.c_str(), routine, io ? &progress : nullptr, MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED
+        )) {
+        errMsg = (io && io->Cancelled()) ? kIoCancelledMessage : GetLastErrorMessage();
+        return false;
+    }
+    return true;
+#else
+    if (rename(src.c_str(), dst.c_str()) == 0) {
+        return true;
+    }
+    if (errno != EXDEV) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+
+    if (!CopyFilePosix(src, dst, false, errMsg, io)) {
+        int savedErr = errno;
+        unlink(dst.c_str());
+        errno = savedErr;
+        return false;
+    }
+    if (unlink(src.c_str()) != 0) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool FilesEqual(const std::string& a, const std::string& b, std::string& errMsg, const IoContext* io) {
+    const size_t bufSize = 65536;
+    std::vector<char> bufA(bufSize);
+    std::vector<char> bufB(bufSize);
+
+#ifdef _WIN32
+    auto openRead = [](const std::string& p) {
+        return CreateFileW(
+            Utf8ToWide(p).c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr
+        );
+    };
+    HANDLE ha = openRead(a);
+    if (ha == INVALID_HANDLE_VALUE) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+    HANDLE hb = openRead(b);
+    if (hb == INVALID_HANDLE_VALUE) {
+        errMsg = GetLastErrorMessage();
+        CloseHandle(ha);
+        return false;
+    }
+
+    bool equal = true;
+    for (;;) {
+        if (io && io->Cancelled()) {
+            errMsg = kIoCancelledMessage;
+            equal = false;
+            break;
+        }
+        DWORD ra = 0;
+        DWORD rb = 0;
+        if (!ReadFile(ha, bufA.data(), static_cast<DWORD>(bufSize), &ra, nullptr) ||
+            !ReadFile(hb, bufB.data(), static_cast<DWORD>(bufSize), &rb, nullptr)) {
+            errMsg = GetLastErrorMessage();
+            equal = false;
+            break;
+        }
+        if (ra != rb || std::memcmp(bufA.data(), bufB.data(), ra) != 0) {
+            equal = false;
+            break;
+        }
+        if (ra == 0) break;
+        if (io && !io->Throttle(static_cast<size_t>(ra) * 2)) {
+            errMsg = kIoCancelledMessage;
+            equal = false;
+            break;
+        }
+    }
+
+    CloseHandle(ha);
+    CloseHandle(hb);
+    return equal;
+#else
+    int fa = open(a.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fa < 0) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+    int fb = open(b.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fb < 0) {
+        errMsg = GetLastErrorMessage();
+        close(fa);
+        return false;
+    }
+
+    bool equal = true;
+    for (;;) {
+        if (io && io->Cancelled()) {
+            errMsg = kIoCancelledMessage;
+            equal = false;
+            break;
+        }
+        ssize_t ra = read(fa, bufA.data(), bufSize);
+        ssize_t rb = read(fb, bufB.data(), bufSize);
+        if (ra < 0 || rb < 0) {
+            errMsg = GetLastErrorMessage();
+            equal = false;
+            break;
+        }
+        if (ra != rb || std::memcmp(bufA.data(), bufB.data(), static_cast<size_t>(ra)) != 0) {
+            equal = false;
+            break;
+        }
+        if (ra == 0) break;
+        if (io && !io->Throttle(static_cast<size_t>(ra) * 2)) {
+            errMsg = kIoCancelledMessage;
+            equal = false;
+            break;
+        }
+    }
+
+    close(fa);
+    close(fb);
+    return equal;
+#endif
+}
+
+bool ReadFileChunks(
+    const std::string& path,
+    const std::function<void(const uint8_t*, size_t)>& sink,
+    std::string& errMsg,
+    const IoContext* io
+) {
+    const size_t bufSize = 256 * 1024;
+    std::vector<uint8_t> buf(bufSize);
+
+#ifdef _WIN32
+    HANDLE h = CreateFileW(
+        Utf8ToWide(path).c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (h == INVALID_HANDLE_VALUE) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+    for (;;) {
+        DWORD readNow = 0;
+        if (!ReadFile(h, buf.data(), static_cast<DWORD>(bufSize), &readNow, nullptr)) {
+            errMsg = GetLastErrorMessage();
+            CloseHandle(h);
+            return false;
+        }
+        if (readNow == 0) break;
+        if (io && !io->Throttle(readNow)) {
+            errMsg = kIoCancelledMessage;
+            CloseHandle(h);
+            return false;
+        }
+        sink(buf.data(), readNow);
+    }
+    CloseHandle(h);
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    for (;;) {
+        ssize_t r = read(fd, buf.data(), bufSize);
+        if (r < 0) {
+            errMsg = GetLastErrorMessage();
+            close(fd);
+            return false;
+        }
+        if (r == 0) break;
+        if (io && !io->Throttle(static_cast<size_t>(r))) {
+            errMsg = kIoCancelledMessage;
+            close(fd);
+            return false;
+        }
+        sink(buf.data(), static_cast<size_t>(r));
+    }
+    close(fd);
+#endif
+    return true;
+}
+
+bool WalkTree(const std::string& root, std::vector<TreeEntry>& out, std::string& errMsg) {
+#ifdef _WIN32
+    std::wstring wroot = Utf8ToWide(root);
+    if (wroot.empty()) {
+        errMsg = "Failed to convert path to wide string";
+        return false;
+    }
+    while (!wroot.empty() && (wroot.back() == L'\\' || wroot.back() == L'/')) {
+        wroot.pop_back();
+    }
+    if (!WalkDirWin(wroot, std::string(), out, errMsg)) {
+        return false;
+    }
+#else
+    int fd = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        errMsg = GetLastErrorMessage();
+        return false;
+    }
+    if (!WalkDirPosix(fd, std::string(), out, errMsg)) {
+        return false;
+    }
+#endif
+    std::sort(out.begin(), out.end(), [](const TreeEntry& l, const TreeEntry& r) { return ComparePaths(l.path, r.path); });
+    return true;
+}
+
+size_t DefaultWorkerCount() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(hw, 2, 8);
+}
+
+void ParallelFor(size_t count, size_t workers, const std::function<void(size_t)>& fn) {
+    workers = std::min(workers, count);
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto run = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t w = 1; w < workers; ++w) threads.emplace_back(run);
+    run();
+    for (auto& t : threads) t.join();
+}
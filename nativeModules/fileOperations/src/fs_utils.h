@@ -0,0 +1,77 @@
+#ifndef FS_UTILS_H
+#define FS_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Functions taking an IoContext check it for cancellation between entries or chunks and
+// charge transferred bytes against its bandwidth budget. On cancellation they fail with
+// errno ECANCELED (ERROR_CANCELLED on Windows) or errMsg set to kIoCancelledMessage.
+struct IoContext;
+
+struct TreeEntry {
+    std::string path;
+    uint64_t size = 0;
+    int64_t mtimeNs = 0;
+    uint32_t mode = 0;
+    bool isDir = false;
+};
+
+std::string GetLastErrorMessage();
+
+#ifdef _WIN32
+std::wstring Utf8ToWide(const std::string& s);
+std::string WideToUtf8(const std::wstring& s);
+bool RemoveDirectoryRecursiveW(const std::wstring& path, const IoContext* io = nullptr);
+#else
+// Removes a directory tree without following symlinks, at the top or anywhere below it.
+bool RemoveDirectoryRecursive(const std::string& path, const IoContext* io = nullptr);
+// Removes the directory `name` inside dirFd and everything under it without following symlinks.
+bool RemoveTreeAt(int dirFd, const char* name, const IoContext* io = nullptr);
+bool CopyFilePosix(const std::string& src, const std::string& dst, bool preserveMetadata, std::string& errMsg, const IoContext* io = nullptr);
+#endif
+
+// Joins a '/'-separated relative path onto a native root path.
+std::string JoinPath(const std::string& root, const std::string& rel);
+
+// Case folding used when comparing relative paths on case-insensitive filesystems.
+std::string PathKey(const std::string& rel);
+
+bool PathExists(const std::string& path, bool* isDir = nullptr);
+bool CreateDirectories(const std::string& path);
+bool RemovePath(const std::string& path, const IoContext* io = nullptr);
+bool RenameReplace(const std::string& src, const std::string& dst);
+
+// Copies file data using the platform's fastest available mechanism and keeps the
+// source permissions and modification time, so a later (size, mtime) comparison matches.
+bool CopyFileFast(const std::string& src, const std::string& dst, std::string& errMsg, const IoContext* io = nullptr);
+bool FilesEqual(const std::string& a, const std::string& b, std::string& errMsg, const IoContext* io = nullptr);
+
+// Renames src onto dst, copying across devices when a plain rename is not possible.
+bool MovePath(const std::string& src, const std::string& dst, std::string& errMsg, const IoContext* io = nullptr);
+
+// Streams a file through sink in fixed-size chunks without loading it whole.
+bool ReadFileChunks(
+    const std::string& path,
+    const std::function<void(const uint8_t*, size_t)>& sink,
+    std::string& errMsg,
+    const IoContext* io = nullptr
+);
+
+// Orders relative paths with '/' below every other character, so a directory is
+// immediately followed by all of its descendants.
+bool ComparePaths(const std::string& l, const std::string& r);
+
+// Lists every file and directory under root (symlinks and reparse points are skipped).
+// Paths are relative to root, '/'-separated and sorted with ComparePaths. Any entry that
+// cannot be read fails the walk, so callers never mistake a partial listing for a
+// complete one; entries removed while the walk is running are skipped.
+bool WalkTree(const std::string& root, std::vector<TreeEntry>& out, std::string& errMsg);
+
+size_t DefaultWorkerCount();
+void ParallelFor(size_t count, size_t workers, const std::function<void(size_t)>& fn);
+
+#endif
@@ -0,0 +1,242 @@
+#include "hashing.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kSha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr uint64_t kXxhPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kXxhPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kXxhPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kXxhPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kXxhPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint32_t Rotr32(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+inline uint64_t Rotl64(uint64_t x, int n) { return (x << n) | (x >> (64 - n)); }
+
+inline uint32_t ReadBe32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline uint32_t ReadLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t ReadLe64(const uint8_t* p) {
+    return static_cast<uint64_t>(ReadLe32(p)) | (static_cast<uint64_t>(ReadLe32(p + 4)) << 32);
+}
+
+inline uint64_t XxhRound(uint64_t acc, uint64_t input) {
+    acc += input * kXxhPrime2;
+    acc = Rotl64(acc, 31);
+    return acc * kXxhPrime1;
+}
+
+inline uint64_t XxhMergeRound(uint64_t acc, uint64_t val) {
+    acc ^= XxhRound(0, val);
+    return acc * kXxhPrime1 + kXxhPrime4;
+}
+
+size_t BlockSize(HashAlgo algo) {
+    return algo == HashAlgo::Sha256 ? 64 : 32;
+}
+
+}  // namespace
+
+bool ParseHashAlgo(const std::string& name, HashAlgo& out) {
+    if (name == "sha256") {
+        out = HashAlgo::Sha256;
+        return true;
+    }
+    if (name == "xxh64") {
+        out = HashAlgo::Xxh64;
+        return true;
+    }
+    return false;
+}
+
+const char* HashAlgoName(HashAlgo algo) {
+    return algo == HashAlgo::Sha256 ? "sha256" : "xxh64";
+}
+
+Hasher::Hasher(HashAlgo algo) : algo_(algo) {
+    if (algo_ == HashAlgo::Sha256) {
+        const uint32_t init[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+        };
+        std::memcpy(sha_, init, sizeof(sha_));
+    } else {
+        xxh_[0] = kXxhPrime1 + kXxhPrime2;
+        xxh_[1] = kXxhPrime2;
+        xxh_[2] = 0;
+        xxh_[3] = 0 - kXxhPrime1;
+    }
+}
+
+void Hasher::Sha256Block(const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) w[i] = ReadBe32(block + i * 4);
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = Rotr32(w[i - 15], 7) ^ Rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = Rotr32(w[i - 2], 17) ^ Rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = sha_[0], b = sha_[1], c = sha_[2], d = sha_[3];
+    uint32_t e = sha_[4], f = sha_[5], g = sha_[6], h = sha_[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t s1 = Rotr32(e, 6) ^ Rotr32(e, 11) ^ Rotr32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + kSha256K[i] + w[i];
+        uint32_t s0 = Rotr32(a, 2) ^ Rotr32(a, 13) ^ Rotr32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    sha_[0] += a; sha_[1] += b; sha_[2] += c; sha_[3] += d;
+    sha_[4] += e; sha_[5] += f; sha_[6] += g; sha_[7] += h;
+}
+
+void Hasher::Xxh64Round4(const uint8_t* p) {
+    xxh_[0] = XxhRound(xxh_[0], ReadLe64(p));
+    xxh_[1] = XxhRound(xxh_[1], ReadLe64(p + 8));
+    xxh_[2] = XxhRound(xxh_[2], ReadLe64(p + 16));
+    xxh_[3] = XxhRound(xxh_[3], ReadLe64(p + 24));
+}
+
+void Hasher::Update(const uint8_t* data, size_t len) {
+    const size_t blockSize = BlockSize(algo_);
+    total_ += len;
+
+    auto consume = [this](const uint8_t* block) {
+        if (algo_ == HashAlgo::Sha256) {
+            Sha256Block(block);
+        } else {
+            Xxh64Round4(block);
+        }
+    };
+
+    if (bufLen_ > 0) {
+        size_t take = blockSize - bufLen_;
+        if (take > len) take = len;
+        std::memcpy(buf_ + bufLen_, data, take);
+        bufLen_ += take;
+        data += take;
+        len -= take;
+        if (bufLen_ < blockSize) return;
+        consume(buf_);
+        bufLen_ = 0;
+    }
+
+    while (len >= blockSize) {
+        consume(data);
+        data += blockSize;
+        len -= blockSize;
+    }
+
+    if (len > 0) {
+        std::memcpy(buf_, data, len);
+        bufLen_ = len;
+    }
+}
+
+std::string Hasher::Digest() {
+    if (algo_ == HashAlgo::Sha256) {
+        uint64_t bitLen = total_ * 8;
+        uint8_t pad[72] = { 0x80 };
+        size_t padLen = (bufLen_ < 56) ? (56 - bufLen_) : (120 - bufLen_);
+        for (int i = 0; i < 8; ++i) {
+            pad[padLen + i] = static_cast<uint8_t>(bitLen >> (56 - i * 8));
+        }
+        uint64_t savedTotal = total_;
+        Update(pad, padLen + 8);
+        total_ = savedTotal;
+
+        std::string out(32, '\0');
+        for (int i = 0; i < 8; ++i) {
+            out[i * 4] = static_cast<char>(sha_[i] >> 24);
+            out[i * 4 + 1] = static_cast<char>(sha_[i] >> 16);
+            out[i * 4 + 2] = static_cast<char>(sha_[i] >> 8);
+            out[i * 4 + 3] = static_cast<char>(sha_[i]);
+        }
+        return out;
+    }
+
+    uint64_t h;
+    if (total_ >= 32) {
+        h = Rotl64(xxh_[0], 1) + Rotl64(xxh_[1], 7) + Rotl64(xxh_[2], 12) + Rotl64(xxh_[3], 18);
+        for (int i = 0; i < 4; ++i) h = XxhMergeRound(h, xxh_[i]);
+    } else {
+        h = kXxhPrime5;
+    }
+    h += total_;
+
+    const uint8_t* p = buf_;
+    size_t len = bufLen_;
+    while (len >= 8) {
+        h ^= XxhRound(0, ReadLe64(p));
+        h = Rotl64(h, 27) * kXxhPrime1 + kXxhPrime4;
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h ^= static_cast<uint64_t>(ReadLe32(p)) * kXxhPrime1;
+        h = Rotl64(h, 23) * kXxhPrime2 + kXxhPrime3;
+        p += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        h ^= static_cast<uint64_t>(*p) * kXxhPrime5;
+        h = Rotl64(h, 11) * kXxhPrime1;
+        ++p;
+        --len;
+    }
+    h ^= h >> 33;
+    h *= kXxhPrime2;
+    h ^= h >> 29;
+    h *= kXxhPrime3;
+    h ^= h >> 32;
+
+    std::string out(8, '\0');
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<char>(h >> (56 - i * 8));
+    }
+    return out;
+}
+
+std::string HashBytes(HashAlgo algo, const uint8_t* data, size_t len) {
+    Hasher hasher(algo);
+    hasher.Update(data, len);
+    return hasher.Digest();
+}
+
+std::string ToHex(const std::string& raw) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(raw.size() * 2);
+    for (unsigned char c : raw) {
+        out.push_back(digits[c >> 4]);
+        out.push_back(digits[c & 0x0f]);
+    }
+    return out;
+}
@@ -0,0 +1,36 @@
+#ifndef HASHING_H
+#define HASHING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class HashAlgo { Sha256, Xxh64 };
+
+bool ParseHashAlgo(const std::string& name, HashAlgo& out);
+const char* HashAlgoName(HashAlgo algo);
+
+// Incremental hasher producing the raw digest (32 bytes for SHA-256, 8 for XXH64).
+class Hasher {
+public:
+    explicit Hasher(HashAlgo algo);
+
+    void Update(const uint8_t* data, size_t len);
+    std::string Digest();
+
+private:
+    void Sha256Block(const uint8_t* block);
+    void Xxh64Round4(const uint8_t* p);
+
+    HashAlgo algo_;
+    uint64_t total_ = 0;
+    uint8_t buf_[64];
+    size_t bufLen_ = 0;
+    uint32_t sha_[8];
+    uint64_t xxh_[4];
+};
+
+std::string HashBytes(HashAlgo algo, const uint8_t* data, size_t len);
+std::string ToHex(const std::string& raw);
+
+#endif
@@ -0,0 +1,199 @@
+#include "io_control.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <string>
+
+namespace {
+
+class IoCancelToken : public Napi::ObjectWrap<IoCancelToken> {
+public:
+    static Napi::FunctionReference* constructor;
+
+    static Napi::Function Init(Napi::Env env) {
+        return DefineClass(env, "IoCancelToken", {
+            InstanceMethod("cancel", &IoCancelToken::Cancel),
+            InstanceMethod("isCancelled", &IoCancelToken::IsCancelled),
+        });
+    }
+
+    explicit IoCancelToken(const Napi::CallbackInfo& info) : Napi::ObjectWrap<IoCancelToken>(info) {
+        if (info.Length() > 0 && info[0].IsNumber()) {
+            double ms = std::max(0.0, info[0].As<Napi::Number>().DoubleValue());
+            auto deadline = IoClock::now() + std::chrono::duration_cast<IoClock::duration>(std::chrono::duration<double, std::milli>(ms));
+            token_ = std::make_shared<CancelToken>(deadline);
+        } else {
+            token_ = std::make_shared<CancelToken>();
+        }
+    }
+
+    const std::shared_ptr<CancelToken>& Token() const { return token_; }
+
+private:
+    Napi::Value Cancel(const Napi::CallbackInfo& info) {
+        token_->Cancel();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value IsCancelled(const Napi::CallbackInfo& info) {
+        return Napi::Boolean::New(info.Env(), token_->IsCancelled());
+    }
+
+    std::shared_ptr<CancelToken> token_;
+};
+
+Napi::FunctionReference* IoCancelToken::constructor = nullptr;
+
+const IoPriority kAllPriorities[kIoPriorityCount] = { IoPriority::Interactive, IoPriority::Normal, IoPriority::Background };
+
+Napi::Value CreateCancelTokenWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() > 0 && !info[0].IsUndefined() && !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Timeout must be a number of milliseconds").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        return IoCancelToken::constructor->New({ info[0] });
+    }
+    return IoCancelToken::constructor->New({});
+}
+
+Napi::Value ConfigureIoSchedulerWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Options must be an object").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object opts = info[0].As<Napi::Object>();
+    IoScheduler& scheduler = IoScheduler::Instance();
+    for (IoPriority priority : kAllPriorities) {
+        Napi::Value value = opts.Get(IoPriorityName(priority));
+        if (value.IsUndefined()) continue;
+        if (!value.IsObject()) {
+            Napi::TypeError::New(env, std::string("Options for '") + IoPriorityName(priority) + "' must be an object")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Object cls = value.As<Napi::Object>();
+        Napi::Value concurrency = cls.Get("concurrency");
+        if (concurrency.IsNumber()) {
+            scheduler.SetConcurrency(priority, static_cast<size_t>(std::max(1, concurrency.As<Napi::Number>().Int32Value())));
+        }
+        Napi::Value bytesPerSec = cls.Get("bytesPerSec");
+        if (bytesPerSec.IsNumber()) {
+            double rate = std::max(0.0, bytesPerSec.As<Napi::Number>().DoubleValue());
+            scheduler.SetBandwidth(priority, static_cast<uint64_t>(rate));
+        }
+    }
+    return env.Undefined();
+}
+
+Napi::Value GetIoSchedulerStatsWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Object result = Napi::Object::New(env);
+    for (IoPriority priority : kAllPriorities) {
+        IoClassStats stats = IoScheduler::Instance().Stats(priority);
+        Napi::Object cls = Napi::Object::New(env);
+        cls.Set("concurrency", Napi::Number::New(env, static_cast<double>(stats.limit)));
+        cls.Set("running", Napi::Number::New(env, static_cast<double>(stats.running)));
+        cls.Set("queued", Napi::Number::New(env, static_cast<double>(stats.queued)));
+        cls.Set("bytesPerSec", Napi::Number::New(env, static_cast<double>(stats.bytesPerSec)));
+        result.Set(IoPriorityName(priority), cls);
+    }
+    return result;
+}
+
+}  // namespace
+
+bool ParseIoOptions(Napi::Env env, Napi::Value options, IoContext& ctx) {
+    if (!options.IsObject()) return true;
+    Napi::Object opts = options.As<Napi::Object>();
+
+    Napi::Value priority = opts.Get("priority");
+    if (!priority.IsUndefined()) {
+        if (!priority.IsString() || !ParseIoPriority(priority.As<Napi::String>().Utf8Value(), ctx.priority)) {
+            Napi::TypeError::New(env, "Priority must be 'interactive', 'normal' or 'background'").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+
+    Napi::Value token = opts.Get("token");
+    if (!token.IsUndefined() && !token.IsNull()) {
+        if (!token.IsObject() || !token.As<Napi::Object>().InstanceOf(IoCancelToken::constructor->Value())) {
+            Napi::TypeError::New(env, "Token must be created with createCancelToken").ThrowAsJavaScriptException();
+            return false;
+        }
+        ctx.token = IoCancelToken::Unwrap(token.As<Napi::Object>())->Token();
+    }
+
+    Napi::Value timeout = opts.Get("timeoutMs");
+    if (timeout.IsNumber()) {
+        double ms = std::max(0.0, timeout.As<Napi::Number>().DoubleValue());
+        ctx.deadline = IoClock::now() + std::chrono::duration_cast<IoClock::duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+    return true;
+}
+
+ScheduledWorker::ScheduledWorker(Napi::Env env, const char* name, IoContext io)
+    : env_(env),
+      // Completion and progress are delivered through the call_js callback, so the
+      // function itself is a no-op; holding the tsfn keeps the event loop alive meanwhile.
+      tsfn_(Napi::ThreadSafeFunction::New(env, Napi::Function::New(env, [](const Napi::CallbackInfo&) {}), name, 0, 1)),
+      io_(std::move(io)) {}
+
+void ScheduledWorker::Queue() {
+    IoScheduler::Instance().Submit(io_, [this](bool granted) { Run(granted); });
+}
+
+void ScheduledWorker::Run(bool granted) {
+    if (!granted) {
+        SetError(kIoCancelledMessage);
+    } else {
+        try {
+            Execute();
+        } catch (const std::exception& e) {
+            SetError(e.what());
+        }
+        if (!error_.empty() && io_.Cancelled()) {
+            SetError(kIoCancelledMessage);
+        }
+    }
+
+    // Complete() deletes this, so release through a copy.
+    Napi::ThreadSafeFunction tsfn = tsfn_;
+    tsfn.BlockingCall(this, [](Napi::Env, Napi::Function, ScheduledWorker* self) { self->Complete(); });
+    tsfn.Release();
+}
+
+void ScheduledWorker::Complete() {
+    Napi::HandleScope scope(env_);
+    try {
+        if (error_.empty()) {
+            OnOK();
+        } else {
+            Napi::Error error = Napi::Error::New(env_, error_);
+            if (io_.Cancelled()) {
+                Napi::Object value = error.Value();
+                value.Set("code", Napi::String::New(env_, "ECANCELED"));
+            }
+            OnError(error);
+        }
+    } catch (const Napi::Error& e) {
+        e.ThrowAsJavaScriptException();
+    }
+    delete this;
+}
+
+void ScheduledWorker::Post(std::function<void(Napi::Env)> fn) {
+    tsfn_.NonBlockingCall([fn = std::move(fn)](Napi::Env env, Napi::Function) { fn(env); });
+}
+
+void RegisterIoControl(Napi::Env env, Napi::Object exports) {
+    IoCancelToken::constructor = new Napi::FunctionReference(Napi::Persistent(IoCancelToken::Init(env)));
+    exports.Set("createCancelToken", Napi::Function::New(env, CreateCancelTokenWrapped));
+    exports.Set("configureIoScheduler", Napi::Function::New(env, ConfigureIoSchedulerWrapped));
+    exports.Set("getIoSchedulerStats", Napi::Function::New(env, GetIoSchedulerStatsWrapped));
+}
@@ -0,0 +1,52 @@
+#ifndef IO_CONTROL_H
+#define IO_CONTROL_H
+
+#include <napi.h>
+
+#include <functional>
+#include <string>
+
+#include "io_scheduler.h"
+
+void RegisterIoControl(Napi::Env env, Napi::Object exports);
+
+// Fills ctx from an options object's `priority`, `token` and `timeoutMs` fields, keeping
+// the caller's defaults for missing ones. Throws and returns false on invalid values.
+bool ParseIoOptions(Napi::Env env, Napi::Value options, IoContext& ctx);
+
+// Counterpart of Napi::AsyncWorker for scheduled I/O. Queue() hands the worker to the
+// IoScheduler, whose own threads run Execute() once the priority class has a free slot;
+// OnOK() or OnError() then run on the JS thread and the worker deletes itself. Nothing
+// waits on the libuv pool. Rejections caused by cancellation or a deadline carry
+// code 'ECANCELED'.
+class ScheduledWorker {
+public:
+    virtual ~ScheduledWorker() = default;
+
+    void Queue();
+
+protected:
+    ScheduledWorker(Napi::Env env, const char* name, IoContext io);
+
+    virtual void Execute() = 0;
+    virtual void OnOK() {}
+    virtual void OnError(const Napi::Error&) {}
+
+    // Runs fn on the JS thread. Posted calls are delivered in order, before OnOK/OnError.
+    void Post(std::function<void(Napi::Env)> fn);
+
+    void SetError(const std::string& error) { error_ = error; }
+    Napi::Env Env() const { return env_; }
+    const IoContext& Io() const { return io_; }
+
+private:
+    void Run(bool granted);
+    void Complete();
+
+    Napi::Env env_;
+    Napi::ThreadSafeFunction tsfn_;
+    IoContext io_;
+    std::string error_;
+};
+
+#endif
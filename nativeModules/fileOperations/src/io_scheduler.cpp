@@ -0,0 +1,276 @@
+#include "io_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+constexpr size_t kDefaultLimits[kIoPriorityCount] = {8, 4, 2};
+constexpr uint64_t kDefaultBackgroundBytesPerSec = 32ull * 1024 * 1024;
+// Smallest burst a throttled class may accumulate, so one read chunk never has to wait twice.
+constexpr double kMinBurstBytes = 256.0 * 1024;
+// Spare worker threads exit after sitting idle this long; one always stays behind.
+constexpr auto kIdleThreadTimeout = std::chrono::seconds(30);
+
+}  // namespace
+
+const char* const kIoCancelledMessage = "Operation cancelled";
+
+bool ParseIoPriority(const std::string& name, IoPriority& out) {
+    if (name == "interactive") {
+        out = IoPriority::Interactive;
+        return true;
+    }
+    if (name == "normal") {
+        out = IoPriority::Normal;
+        return true;
+    }
+    if (name == "background") {
+        out = IoPriority::Background;
+        return true;
+    }
+    return false;
+}
+
+const char* IoPriorityName(IoPriority priority) {
+    switch (priority) {
+    case IoPriority::Interactive:
+        return "interactive";
+    case IoPriority::Background:
+        return "background";
+    default:
+        return "normal";
+    }
+}
+
+CancelToken::CancelToken(IoClock::time_point deadline) : deadline_(deadline) {}
+
+void CancelToken::Cancel() {
+    if (!cancelled_.exchange(true)) {
+        IoScheduler::Instance().Wake();
+    }
+}
+
+bool CancelToken::IsCancelled() const {
+    if (cancelled_.load(std::memory_order_relaxed)) return true;
+    return HasDeadline() && IoClock::now() >= deadline_;
+}
+
+bool IoContext::Cancelled() const {
+    if (token && token->IsCancelled()) return true;
+    return deadline != IoClock::time_point::max() && IoClock::now() >= deadline;
+}
+
+IoClock::time_point IoContext::EffectiveDeadline() const {
+    return token ? std::min(deadline, token->Deadline()) : deadline;
+}
+
+bool IoContext::Throttle(size_t bytes) const {
+    return IoScheduler::Instance().Throttle(*this, bytes);
+}
+
+IoScheduler& IoScheduler::Instance() {
+    // Intentionally leaked: detached worker threads may still touch it during process teardown.
+    static IoScheduler* instance = new IoScheduler();
+    return *instance;
+}
+
+IoScheduler::IoScheduler() {
+    auto now = IoClock::now();
+    for (size_t i = 0; i < kIoPriorityCount; ++i) {
+        classes_[i].limit = kDefaultLimits[i];
+        classes_[i].refilledAt = now;
+    }
+    classes_[static_cast<size_t>(IoPriority::Background)].bytesPerSec = kDefaultBackgroundBytesPerSec;
+}
+
+bool IoScheduler::HigherBusy(size_t cls) const {
+    for (size_t i = 0; i < cls; ++i) {
+        if (classes_[i].running > 0 || !classes_[i].queue.empty()) return true;
+    }
+    return false;
+}
+
+void IoScheduler::Submit(const IoContext& ctx, IoTask task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        classes_[static_cast<size_t>(ctx.priority)].queue.push_back(Pending{ctx, std::move(task)});
+        if (idleThreads_ == 0) SpawnThreadLocked();
+    }
+    cv_.notify_all();
+}
+
+size_t IoScheduler::ClaimExtra(const IoContext& ctx, size_t wanted) {
+    const size_t cls = static_cast<size_t>(ctx.priority);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i <= cls; ++i) {
+        if (!classes_[i].queue.empty()) return 0;
+    }
+    ClassState& state = classes_[cls];
+    const size_t available = state.limit > state.running ? state.limit - state.running : 0;
+    const size_t claimed = std::min(wanted, available);
+    state.running += claimed;
+    return claimed;
+}
+
+void IoScheduler::ReleaseExtra(IoPriority priority, size_t count) {
+    if (count == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ClassState& state = classes_[static_cast<size_t>(priority)];
+        state.running -= std::min(count, state.running);
+    }
+    cv_.notify_all();
+}
+
+bool IoScheduler::TakeNext(Pending& out, bool& granted, size_t& cls) {
+    // Settle cancelled operations first so their callers do not wait behind running work.
+    for (size_t i = 0; i < kIoPriorityCount; ++i) {
+        auto& queue = classes_[i].queue;
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->ctx.Cancelled()) {
+                out = std::move(*it);
+                queue.erase(it);
+                granted = false;
+                cls = i;
+                return true;
+            }
+        }
+    }
+    for (size_t i = 0; i < kIoPriorityCount; ++i) {
+        ClassState& state = classes_[i];
+        if (state.queue.empty()) continue;
+        // A saturated class with waiters holds back every lower class.
+        if (state.running >= state.limit) return false;
+        out = std::move(state.queue.front());
+        state.queue.pop_front();
+        ++state.running;
+        granted = true;
+        cls = i;
+        return true;
+    }
+    return false;
+}
+
+IoClock::time_point IoScheduler::EarliestDeadline() const {
+    IoClock::time_point earliest = IoClock::time_point::max();
+    for (const ClassState& state : classes_) {
+        for (const Pending& pending : state.queue) {
+            earliest = std::min(earliest, pending.ctx.EffectiveDeadline());
+        }
+    }
+    return earliest;
+}
+
+void IoScheduler::SpawnThreadLocked() {
+    ++idleThreads_;
+    std::thread([this] { ThreadMain(); }).detach();
+}
+
+void IoScheduler::ThreadMain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        Pending pending;
+        bool granted = false;
+        size_t cls = 0;
+        if (!TakeNext(pending, granted, cls)) {
+            const IoClock::time_point deadline = EarliestDeadline();
+            const IoClock::time_point idleUntil = IoClock::now() + kIdleThreadTimeout;
+            if (cv_.wait_until(lock, std::min(deadline, idleUntil)) == std::cv_status::timeout && deadline > idleUntil &&
+                idleThreads_ > 1) {
+                --idleThreads_;
+                return;
+            }
+            continue;
+        }
+
+        // Keep one thread idle so queued operations can still be cancelled while every
+        // other thread is busy.
+        if (--idleThreads_ == 0) SpawnThreadLocked();
+        lock.unlock();
+        try {
+            pending.task(granted);
+        } catch (...) {
+        }
+        pending.task = nullptr;
+        lock.lock();
+
+        if (granted && classes_[cls].running > 0) --classes_[cls].running;
+        ++idleThreads_;
+        cv_.notify_all();
+    }
+}
+
+bool IoScheduler::Throttle(const IoContext& ctx, size_t bytes) {
+    const size_t cls = static_cast<size_t>(ctx.priority);
+    std::unique_lock<std::mutex> lock(mutex_);
+    ClassState& state = classes_[cls];
+
+    if (state.bytesPerSec == 0 || !HigherBusy(cls)) {
+        return !ctx.Cancelled();
+    }
+
+    const double rate = static_cast<double>(state.bytesPerSec);
+    const IoClock::time_point now = IoClock::now();
+    const double elapsed = std::chrono::duration<double>(now - state.refilledAt).count();
+    state.refilledAt = now;
+    state.budget = std::min(state.budget + elapsed * rate, std::max(rate / 4, kMinBurstBytes));
+    state.budget -= static_cast<double>(bytes);
+    if (state.budget >= 0) {
+        return !ctx.Cancelled();
+    }
+
+    const IoClock::time_point resumeAt =
+        now + std::chrono::duration_cast<IoClock::duration>(std::chrono::duration<double>(-state.budget / rate));
+    const IoClock::time_point wakeAt = std::min(resumeAt, ctx.EffectiveDeadline());
+    // Stop waiting as soon as the higher-priority work drains; the debt is repaid on the next refill.
+    while (IoClock::now() < resumeAt && HigherBusy(cls)) {
+        if (ctx.Cancelled()) return false;
+        cv_.wait_until(lock, wakeAt);
+    }
+    return !ctx.Cancelled();
+}
+
+void IoScheduler::SetConcurrency(IoPriority priority, size_t limit) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        classes_[static_cast<size_t>(priority)].limit = std::max<size_t>(limit, 1);
+    }
+    cv_.notify_all();
+}
+
+void IoScheduler::SetBandwidth(IoPriority priority, uint64_t bytesPerSec) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ClassState& state = classes_[static_cast<size_t>(priority)];
+        state.bytesPerSec = bytesPerSec;
+        state.budget = 0;
+        state.refilledAt = IoClock::now();
+    }
+    cv_.notify_all();
+}
+
+IoClassStats IoScheduler::Stats(IoPriority priority) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const ClassState& state = classes_[static_cast<size_t>(priority)];
+    IoClassStats stats;
+    stats.limit = state.limit;
+    stats.running = state.running;
+    stats.queued = state.queue.size();
+    stats.bytesPerSec = state.bytesPerSec;
+    return stats;
+}
+
+void IoScheduler::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cv_.notify_all();
+}
+
+IoFanOut::IoFanOut(const IoContext& ctx, size_t wanted)
+    : priority_(ctx.priority), extra_(wanted > 1 ? IoScheduler::Instance().ClaimExtra(ctx, wanted - 1) : 0) {}
+
+IoFanOut::~IoFanOut() {
+    IoScheduler::Instance().ReleaseExtra(priority_, extra_);
+}
@@ -0,0 +1,140 @@
+#ifndef IO_SCHEDULER_H
+#define IO_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+enum class IoPriority { Interactive = 0, Normal = 1, Background = 2 };
+constexpr size_t kIoPriorityCount = 3;
+
+bool ParseIoPriority(const std::string& name, IoPriority& out);
+const char* IoPriorityName(IoPriority priority);
+
+using IoClock = std::chrono::steady_clock;
+
+// Cancellation flag shared between JS and worker threads. A token with a deadline
+// reports itself cancelled once the deadline has passed.
+class CancelToken {
+public:
+    CancelToken() = default;
+    explicit CancelToken(IoClock::time_point deadline);
+
+    void Cancel();
+    bool IsCancelled() const;
+    bool HasDeadline() const { return deadline_ != IoClock::time_point::max(); }
+    IoClock::time_point Deadline() const { return deadline_; }
+
+private:
+    std::atomic<bool> cancelled_{false};
+    IoClock::time_point deadline_ = IoClock::time_point::max();
+};
+
+struct IoContext {
+    IoPriority priority = IoPriority::Normal;
+    std::shared_ptr<CancelToken> token;
+    IoClock::time_point deadline = IoClock::time_point::max();
+
+    bool Cancelled() const;
+    // Earliest of the operation deadline and the token deadline.
+    IoClock::time_point EffectiveDeadline() const;
+    // Charges bytes against the class bandwidth budget, sleeping when it is exhausted.
+    // Returns false if the operation was cancelled while waiting.
+    bool Throttle(size_t bytes) const;
+};
+
+struct IoClassStats {
+    size_t limit = 0;
+    size_t running = 0;
+    size_t queued = 0;
+    uint64_t bytesPerSec = 0;
+};
+
+// Work handed to the scheduler. `granted` is false when the operation was cancelled or
+// hit its deadline while still queued; the task runs anyway so it can settle its caller.
+using IoTask = std::function<void(bool granted)>;
+
+// Process-wide arbiter for native file I/O. Every operation runs in one of three
+// priority classes, each with its own concurrency limit; a class does not start new
+// work while a higher class has operations waiting for a slot. Tasks run on the
+// scheduler's own threads, so queued or long-running I/O never occupies the libuv
+// pool that Node's fs, zlib and crypto share. Background transfers are additionally
+// rate limited while higher-priority work is in flight.
+class IoScheduler {
+public:
+    static IoScheduler& Instance();
+
+    void Submit(const IoContext& ctx, IoTask task);
+    bool Throttle(const IoContext& ctx, size_t bytes);
+
+    // Claims up to `wanted` free slots of ctx's class without waiting, for an operation
+    // that already holds one slot and fans its I/O out across threads. Nothing is claimed
+    // while the class or a higher one has queued work. Give them back with ReleaseExtra.
+    size_t ClaimExtra(const IoContext& ctx, size_t wanted);
+    void ReleaseExtra(IoPriority priority, size_t count);
+
+    void SetConcurrency(IoPriority priority, size_t limit);
+    void SetBandwidth(IoPriority priority, uint64_t bytesPerSec);
+    IoClassStats Stats(IoPriority priority) const;
+
+    // Wakes waiters so they can observe a cancelled token.
+    void Wake();
+
+private:
+    IoScheduler();
+
+    struct Pending {
+        IoContext ctx;
+        IoTask task;
+    };
+
+    struct ClassState {
+        size_t limit = 0;
+        size_t running = 0;
+        std::deque<Pending> queue;
+        uint64_t bytesPerSec = 0;
+        double budget = 0;
+        IoClock::time_point refilledAt;
+    };
+
+    bool HigherBusy(size_t cls) const;
+    // Picks the next task for an idle thread: cancelled tasks first, then the highest
+    // class with a free slot. Returns false when nothing can run yet.
+    bool TakeNext(Pending& out, bool& granted, size_t& cls);
+    IoClock::time_point EarliestDeadline() const;
+    void SpawnThreadLocked();
+    void ThreadMain();
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    ClassState classes_[kIoPriorityCount];
+    size_t idleThreads_ = 0;
+};
+
+// Worker count for a fanned-out scheduled operation: its own slot plus whatever extra
+// slots of the class were free, so parallel copies and hashes stay within the class limit.
+class IoFanOut {
+public:
+    IoFanOut(const IoContext& ctx, size_t wanted);
+    ~IoFanOut();
+
+    IoFanOut(const IoFanOut&) = delete;
+    IoFanOut& operator=(const IoFanOut&) = delete;
+
+    size_t Workers() const { return 1 + extra_; }
+
+private:
+    IoPriority priority_;
+    size_t extra_;
+};
+
+extern const char* const kIoCancelledMessage;
+
+#endif
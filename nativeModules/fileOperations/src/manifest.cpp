@@ -0,0 +1,372 @@
+#include "manifest.h"
+#include "fs_utils.h"
+#include "hashing.h"
+#include "io_control.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ManifestEntry {
+    std::string path;
+    uint64_t size = 0;
+    uint32_t mode = 0;
+    std::string hash;
+};
+
+// '*' and '?' stay within one path segment, '**' spans segments.
+bool GlobMatch(const char* p, const char* s) {
+    for (; *p; ++p) {
+        if (*p == '*') {
+            bool deep = p[1] == '*';
+            while (*p == '*') ++p;
+            if (deep && *p == '/' && GlobMatch(p + 1, s)) return true;
+            for (const char* t = s;; ++t) {
+                if (GlobMatch(p, t)) return true;
+                if (*t == '\0' || (!deep && *t == '/')) return false;
+            }
+        }
+        if (*s == '\0') return false;
+        if (*p == '?') {
+            if (*s == '/') return false;
+        } else if (*p != *s) {
+            return false;
+        }
+        ++s;
+    }
+    return *s == '\0';
+}
+
+// Patterns without a '/' apply to the entry name at any depth, like .gitignore.
+bool IsExcluded(const std::vector<std::string>& patterns, const std::string& path) {
+    size_t slash = path.rfind('/');
+    const char* name = path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    for (const auto& pattern : patterns) {
+        bool anchored = pattern.find('/') != std::string::npos;
+        if (GlobMatch(pattern.c_str(), anchored ? path.c_str() : name)) return true;
+    }
+    return false;
+}
+
+// Manifests carry git-style modes (0644 or 0755) so that identical content produces the
+// same root on every platform; umask and read-only bits are local noise. Windows has no
+// executable bit, so every file is 0644 there.
+uint32_t NormalizeMode(uint32_t mode) {
+#ifdef _WIN32
+    (void)mode;
+    return 0644;
+#else
+    return (mode & 0111) ? 0755 : 0644;
+#endif
+}
+
+// Leaves are H(0x00 || path || 0x00 || mode(be32) || fileHash), inner nodes H(0x01 || left || right);
+// an odd node at the end of a level is paired with itself.
+std::string MerkleRoot(HashAlgo algo, const std::vector<ManifestEntry>& files) {
+    if (files.empty()) return HashBytes(algo, nullptr, 0);
+
+    std::vector<std::string> level;
+    level.reserve(files.size());
+    for (const auto& file : files) {
+        std::string leaf(1, '\0');
+        leaf += file.path;
+        leaf.push_back('\0');
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            leaf.push_back(static_cast<char>((file.mode >> shift) & 0xff));
+        }
+        leaf += file.hash;
+        level.push_back(HashBytes(algo, reinterpret_cast<const uint8_t*>(leaf.data()), leaf.size()));
+    }
+
+    while (level.size() > 1) {
+        std::vector<std::string> next;
+        next.reserve((level.size() + 1) / 2);
+        for (size_t i = 0; i < level.size(); i += 2) {
+            const std::string& right = i + 1 < level.size() ? level[i + 1] : level[i];
+            std::string node(1, '\x01');
+            node += level[i];
+            node += right;
+            next.push_back(HashBytes(algo, reinterpret_cast<const uint8_t*>(node.data()), node.size()));
+        }
+        level.swap(next);
+    }
+    return level[0];
+}
+
+class BuildManifestWorker : public ScheduledWorker {
+public:
+    BuildManifestWorker(
+        Napi::Env env,
+        std::string root,
+        HashAlgo algo,
+        std::vector<std::string> exclude,
+        size_t workers,
+        IoContext io
+    )
+        : ScheduledWorker(env, "BuildManifest", std::move(io)),
+          deferred_(Napi::Promise::Deferred::New(env)),
+          root_(std::move(root)),
+          algo_(algo),
+          exclude_(std::move(exclude)),
+          workers_(workers) {}
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        std::vector<TreeEntry> entries;
+        std::string errMsg;
+        if (!WalkTree(root_, entries, errMsg)) {
+            SetError("Failed to read directory: " + errMsg);
+            return;
+        }
+
+        std::string excludedPrefix;
+        for (const auto& entry : entries) {
+            if (!excludedPrefix.empty() && entry.path.compare(0, excludedPrefix.size(), excludedPrefix) == 0) {
+                continue;
+            }
+            excludedPrefix.clear();
+            if (!exclude_.empty() && IsExcluded(exclude_, entry.path)) {
+                if (entry.isDir) excludedPrefix = entry.path + "/";
+                continue;
+            }
+            if (entry.isDir) continue;
+
+            ManifestEntry file;
+            file.path = entry.path;
+            file.size = entry.size;
+            file.mode = NormalizeMode(entry.mode);
+            files_.push_back(std::move(file));
+        }
+
+        std::atomic<bool> failed{false};
+        std::mutex errorMutex;
+        std::string firstError;
+        IoFanOut fanOut(Io(), std::min(workers_, files_.size()));
+        ParallelFor(files_.size(), fanOut.Workers(), [&](size_t i) {
+            if (failed.load()) return;
+            ManifestEntry& file = files_[i];
+            Hasher hasher(algo_);
+            std::string err;
+            bool ok = ReadFileChunks(
+                JoinPath(root_, file.path),
+                [&hasher](const uint8_t* data, size_t len) { hasher.Update(data, len); },
+                err,
+                &Io()
+            );
+            if (!ok) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.exchange(true)) {
+                    firstError = Io().Cancelled() ? std::string(kIoCancelledMessage) : "Failed to hash '" + file.path + "': " + err;
+                }
+                return;
+            }
+            file.hash = hasher.Digest();
+        });
+
+        if (failed.load()) {
+            SetError(firstError);
+            return;
+        }
+
+        merkleRoot_ = MerkleRoot(algo_, files_);
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        Napi::Array files = Napi::Array::New(env, files_.size());
+        for (size_t i = 0; i < files_.size(); ++i) {
+            const ManifestEntry& file = files_[i];
+            Napi::Object entry = Napi::Object::New(env);
+            entry.Set("path", Napi::String::New(env, file.path));
+            entry.Set("size", Napi::Number::New(env, static_cast<double>(file.size)));
+            entry.Set("mode", Napi::Number::New(env, file.mode));
+            entry.Set("hash", Napi::String::New(env, ToHex(file.hash)));
+            files.Set(static_cast<uint32_t>(i), entry);
+        }
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("algo", Napi::String::New(env, HashAlgoName(algo_)));
+        result.Set("root", Napi::String::New(env, ToHex(merkleRoot_)));
+        result.Set("files", files);
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& e) override {
+        deferred_.Reject(e.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    std::string root_;
+    HashAlgo algo_;
+    std::vector<std::string> exclude_;
+    size_t workers_;
+    std::vector<ManifestEntry> files_;
+    std::string merkleRoot_;
+};
+
+Napi::Value BuildManifestWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Path must be a string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    std::string root = info[0].As<Napi::String>().Utf8Value();
+    HashAlgo algo = HashAlgo::Sha256;
+    std::vector<std::string> exclude;
+    size_t workers = DefaultWorkerCount();
+    IoContext io;
+    io.priority = IoPriority::Background;
+
+    if (info.Length() > 1 && !ParseIoOptions(env, info[1], io)) {
+        return env.Null();
+    }
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object opts = info[1].As<Napi::Object>();
+        Napi::Value algoValue = opts.Get("algo");
+        if (algoValue.IsString() && !ParseHashAlgo(algoValue.As<Napi::String>().Utf8Value(), algo)) {
+            Napi::TypeError::New(env, "Hash algorithm must be 'sha256' or 'xxh64'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Value excludeValue = opts.Get("exclude");
+        if (excludeValue.IsArray()) {
+            Napi::Array patterns = excludeValue.As<Napi::Array>();
+            for (uint32_t i = 0; i < patterns.Length(); ++i) {
+                Napi::Value pattern = patterns.Get(i);
+                if (pattern.IsString()) exclude.push_back(pattern.As<Napi::String>().Utf8Value());
+            }
+        }
+        Napi::Value workersValue = opts.Get("workers");
+        if (workersValue.IsNumber()) {
+            workers = static_cast<size_t>(std::max(1, workersValue.As<Napi::Number>().Int32Value()));
+        }
+    }
+
+    auto* worker = new BuildManifestWorker(env, std::move(root), algo, std::move(exclude), workers, std::move(io));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+struct ParsedManifest {
+    std::string algo;
+    std::string root;
+    std::vector<ManifestEntry> files;
+};
+
+bool ParseManifest(Napi::Env env, const Napi::Value& value, ParsedManifest& out) {
+    if (!value.IsObject()) {
+        Napi::TypeError::New(env, "Manifest must be an object").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Object obj = value.As<Napi::Object>();
+    Napi::Value algo = obj.Get("algo");
+    Napi::Value root = obj.Get("root");
+    Napi::Value files = obj.Get("files");
+    if (!files.IsArray()) {
+        Napi::TypeError::New(env, "Manifest files must be an array").ThrowAsJavaScriptException();
+        return false;
+    }
+    out.algo = algo.IsString() ? algo.As<Napi::String>().Utf8Value() : std::string();
+    out.root = root.IsString() ? root.As<Napi::String>().Utf8Value() : std::string();
+
+    Napi::Array arr = files.As<Napi::Array>();
+    out.files.reserve(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); ++i) {
+        Napi::Value item = arr.Get(i);
+        if (!item.IsObject()) continue;
+        Napi::Object entry = item.As<Napi::Object>();
+        Napi::Value path = entry.Get("path");
+        if (!path.IsString()) continue;
+
+        ManifestEntry file;
+        file.path = path.As<Napi::String>().Utf8Value();
+        Napi::Value size = entry.Get("size");
+        Napi::Value mode = entry.Get("mode");
+        Napi::Value hash = entry.Get("hash");
+        file.size = size.IsNumber() ? static_cast<uint64_t>(size.As<Napi::Number>().Int64Value()) : 0;
+        file.mode = mode.IsNumber() ? mode.As<Napi::Number>().Uint32Value() : 0;
+        file.hash = hash.IsString() ? hash.As<Napi::String>().Utf8Value() : std::string();
+        out.files.push_back(std::move(file));
+    }
+
+    std::sort(out.files.begin(), out.files.end(), [](const ManifestEntry& l, const ManifestEntry& r) {
+        return ComparePaths(l.path, r.path);
+    });
+    return true;
+}
+
+Napi::Value DiffManifestWrapped(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "Expected (a: manifest, b: manifest)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    ParsedManifest a;
+    ParsedManifest b;
+    if (!ParseManifest(env, info[0], a) || !ParseManifest(env, info[1], b)) {
+        return env.Null();
+    }
+
+    Napi::Array added = Napi::Array::New(env);
+    Napi::Array removed = Napi::Array::New(env);
+    Napi::Array changed = Napi::Array::New(env);
+    Napi::Array modeChanged = Napi::Array::New(env);
+    uint32_t addedCount = 0;
+    uint32_t removedCount = 0;
+    uint32_t changedCount = 0;
+    uint32_t modeChangedCount = 0;
+
+    // Hashes from different algorithms are not comparable, so only the root shortcut
+    // and the per-file hash check require a matching algorithm.
+    bool sameAlgo = a.algo == b.algo;
+    if (!(sameAlgo && !a.root.empty() && a.root == b.root)) {
+        size_t i = 0;
+        size_t j = 0;
+        while (i < a.files.size() || j < b.files.size()) {
+            if (j >= b.files.size() || (i < a.files.size() && ComparePaths(a.files[i].path, b.files[j].path))) {
+                removed.Set(removedCount++, Napi::String::New(env, a.files[i].path));
+                ++i;
+                continue;
+            }
+            if (i >= a.files.size() || ComparePaths(b.files[j].path, a.files[i].path)) {
+                added.Set(addedCount++, Napi::String::New(env, b.files[j].path));
+                ++j;
+                continue;
+            }
+
+            const ManifestEntry& fa = a.files[i];
+            const ManifestEntry& fb = b.files[j];
+            if (fa.size != fb.size || !sameAlgo || fa.hash != fb.hash) {
+                changed.Set(changedCount++, Napi::String::New(env, fa.path));
+            } else if (fa.mode != fb.mode) {
+                modeChanged.Set(modeChangedCount++, Napi::String::New(env, fa.path));
+            }
+            ++i;
+            ++j;
+        }
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("equal", Napi::Boolean::New(env, addedCount == 0 && removedCount == 0 && changedCount == 0 && modeChangedCount == 0));
+    result.Set("added", added);
+    result.Set("removed", removed);
+    result.Set("changed", changed);
+    result.Set("modeChanged", modeChanged);
+    return result;
+}
+
+}  // namespace
+
+void RegisterManifest(Napi::Env env, Napi::Object exports) {
+    exports.Set("buildManifest", Napi::Function::New(env, BuildManifestWrapped));
+    exports.Set("diffManifest", Napi::Function::New(env, DiffManifestWrapped));
+}
@@ -0,0 +1,8 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <napi.h>
+
+void RegisterManifest(Napi::Env env, Napi::Object exports);
+
+#endif
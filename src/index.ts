@@ -25,7 +25,7 @@ import { handleEvents } from './main/events'
 import { initMainI18n, t } from './main/i18n'
 import Addon from '@entities/addon/model/addon.interface'
 import { getState } from './main/modules/state'
-import { startThemeWatcher } from './main/modules/nativeModules'
+import { startThemeWatcher, stopThemeWatcher } from './main/modules/nativeModules'
 import * as fsp from 'fs/promises'
 import MainEvents from './common/types/mainEvents'
 import RendererEvents from './common/types/rendererEvents'
@@ -513,7 +513,8 @@ export async function prestartCheck() {
     createDefaultAddonIfNotExists(themesPath)
     await migrateLegacyAddonSettings(themesPath)
     try {
-        startThemeWatcher(themesPath)
+        startThemeWatcher(themesPath, 1000, path.join(app.getPath('userData'), 'addons-watch-index.bin'))
+        app.once('will-quit', stopThemeWatcher)
     } catch (e) {
         logger.main.error('Error setting up file watcher for themes:', e)
     }
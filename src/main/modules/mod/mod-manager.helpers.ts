@@ -16,7 +16,7 @@ import {
 } from '../../utils/appUtils'
 import { Paths, writePatchedAsarAndPatchBundle } from './mod-files'
 import { downloadAndUpdateFile } from './network'
-import { nativeDeleteFile, nativeFileExists } from '../nativeModules'
+import { nativeDeleteFileAsync, nativeFileExists } from '../nativeModules'
 import { resetProgress, sendProgress, sendToRenderer, setProgress } from './download.helpers'
 import { CACHE_DIR } from '../../constants/paths'
 import { t } from '../../i18n'
@@ -117,7 +117,7 @@ export async function cleanupModArtifacts(paths: Paths): Promise<void> {
     const unpackedDir = path.join(path.dirname(paths.modAsar), 'app.asar.unpacked')
     try {
         if (fs.existsSync(unpackedDir)) {
-            nativeDeleteFile(unpackedDir)
+            await nativeDeleteFileAsync(unpackedDir, { priority: 'background' })
         }
     } catch (e) {
         logger.modManager.warn('Failed to delete unpacked dir:', e)
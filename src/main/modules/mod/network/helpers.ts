@@ -4,6 +4,7 @@ import crypto from 'crypto'
 import AdmZip from 'adm-zip'
 import logger from '../../logger'
 import { gunzipAsync, zstdDecompressAsync } from '../mod-files'
+import { nativeBuildManifest } from '../../nativeModules'
 import type { ReplaceDirFailure, ReplaceDirResult, RetryStageFailure, RetryStageResult } from './types'
 
 export const UNPACKED_MARKER_FILE = '.pulsesync_unpacked_checksum'
@@ -129,26 +130,46 @@ export function resolveExtractedRoot(extractDir: string, targetPath: string): st
     return path.join(extractDir, only.name)
 }
 
-export function readUnpackedMarker(targetPath: string): string | null {
+export interface UnpackedMarker {
+    checksum: string
+    treeRoot: string | null
+}
+
+// The marker holds the archive checksum on the first line and, when the native addon is
+// available, the manifest root of the extracted tree ("<algo>:<root>") on the second.
+export function readUnpackedMarker(targetPath: string): UnpackedMarker | null {
     try {
         const markerPath = path.join(targetPath, UNPACKED_MARKER_FILE)
         if (!fs.existsSync(markerPath)) return null
-        const v = fs.readFileSync(markerPath, 'utf8').trim()
-        return v || null
+        const [checksum = '', treeRoot = ''] = fs.readFileSync(markerPath, 'utf8').split('\n').map(line => line.trim())
+        return checksum ? { checksum, treeRoot: treeRoot || null } : null
     } catch {
         return null
     }
 }
 
-export function writeUnpackedMarker(targetPath: string, checksum: string): void {
+export function writeUnpackedMarker(targetPath: string, checksum: string, treeRoot?: string | null): void {
     try {
         const markerPath = path.join(targetPath, UNPACKED_MARKER_FILE)
-        fs.writeFileSync(markerPath, `${checksum}\n`, 'utf8')
+        fs.writeFileSync(markerPath, treeRoot ? `${checksum}\n${treeRoot}\n` : `${checksum}\n`, 'utf8')
     } catch (e) {
         logger.modManager.warn('Failed to write unpacked marker:', e)
     }
 }
 
+export async function computeUnpackedTreeRoot(targetPath: string): Promise<string | null> {
+    const manifest = await nativeBuildManifest(targetPath, { algo: 'xxh64', exclude: [UNPACKED_MARKER_FILE] })
+    return manifest ? `${manifest.algo}:${manifest.root}` : null
+}
+
+// Markers written before tree roots were recorded, or without the native addon, can only
+// vouch for the archive checksum, so they are trusted as before.
+export async function isUnpackedTreeIntact(targetPath: string, marker: UnpackedMarker): Promise<boolean> {
+    if (!marker.treeRoot) return true
+    const current = await computeUnpackedTreeRoot(targetPath)
+    return current === null || current === marker.treeRoot
+}
+
 function cleanupTempExtractPath(sourceDir: string, tempExtractPath: string): void {
     if (sourceDir === tempExtractPath) return
     fs.rmSync(tempExtractPath, { recursive: true, force: true })
@@ -20,10 +20,12 @@ import {
 import { isLinuxAccessError } from '../../../utils/appUtils/elevation'
 import type { DownloadProgress, ModDownloadFailure } from './types'
 import {
+    computeUnpackedTreeRoot,
     decompressArchive,
     ensureDir,
     extractZipBuffer,
     isReplaceDirFailure,
+    isUnpackedTreeIntact,
     pruneCacheFiles,
     readCachedArchive,
     readUnpackedMarker,
@@ -147,15 +149,20 @@ export async function downloadAndExtractUnpacked(
     try {
         if (checksum && fs.existsSync(targetPath)) {
             const installed = readUnpackedMarker(targetPath)
-            if (installed && installed === checksum) {
+            const intact = installed !== null && installed.checksum === checksum && (await isUnpackedTreeIntact(targetPath, installed))
+            if (intact) {
                 logger.modManager.info('app.asar.unpacked hash matches, skipping')
                 if (progress?.resetOnComplete ?? true) {
                     resetProgress(window)
                 }
                 return true
             }
-            if (installed && installed !== checksum) {
-                logger.modManager.info(`app.asar.unpacked hash mismatch, reinstalling`)
+            if (installed) {
+                logger.modManager.info(
+                    installed.checksum === checksum
+                        ? 'app.asar.unpacked was modified since install, reinstalling'
+                        : 'app.asar.unpacked hash mismatch, reinstalling',
+                )
                 try {
                     fs.rmSync(targetPath, { recursive: true, force: true })
                 } catch (e) {
@@ -238,7 +245,7 @@ export async function downloadAndExtractUnpacked(
         }
 
         if (checksum) {
-            writeUnpackedMarker(targetPath, checksum)
+            writeUnpackedMarker(targetPath, checksum, await computeUnpackedTreeRoot(targetPath))
         }
 
         if (progress?.resetOnComplete ?? true) {
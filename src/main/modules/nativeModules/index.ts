@@ -7,13 +7,130 @@ import { sendAddon, sendAddonSettings, sendAllAddonSettings, sendExtensions } fr
 
 declare const __non_vite_require__: (moduleId: string) => any
 
+export interface WatchOptions {
+    indexPath?: string
+}
+
+export type NativeIoPriority = 'interactive' | 'normal' | 'background'
+
+export interface NativeCancelToken {
+    cancel(): void
+    isCancelled(): boolean
+}
+
+export interface NativeIoOptions {
+    priority?: NativeIoPriority
+    token?: NativeCancelToken
+    timeoutMs?: number
+}
+
+export interface NativeIoClassConfig {
+    concurrency?: number
+    bytesPerSec?: number
+}
+
+export interface NativeIoClassStats {
+    concurrency: number
+    running: number
+    queued: number
+    bytesPerSec: number
+}
+
+export type NativeIoSchedulerConfig = Partial<Record<NativeIoPriority, NativeIoClassConfig>>
+export type NativeIoSchedulerStats = Record<NativeIoPriority, NativeIoClassStats>
+
+export interface SyncTreeProgress {
+    phase: 'scan' | 'copy' | 'commit' | 'delete'
+    done: number
+    total: number
+    bytes: number
+}
+
+export interface SyncTreeOptions extends NativeIoOptions {
+    delete?: boolean
+    verify?: boolean
+    workers?: number
+    onProgress?: (progress: SyncTreeProgress) => void
+}
+
+export interface SyncTreeResult {
+    copied: number
+    unchanged: number
+    deleted: number
+    dirsCreated: number
+    bytesCopied: number
+}
+
+export interface NativeDirStat {
+    size: number
+    mtimeMs: number
+    mode: number
+    isFile: boolean
+    isDirectory: boolean
+}
+
+export interface NativeDirEntry {
+    name: string
+    isDirectory: boolean
+}
+
+export interface NativeDirHandle {
+    exists(relPath: string): boolean
+    read(relPath: string): Buffer
+    stat(relPath: string): NativeDirStat | null
+    delete(relPath: string): void
+    rename(from: string, to: string, mode?: 'replace' | 'noreplace' | 'exchange'): void
+    list(relPath?: string): NativeDirEntry[]
+    close(): void
+}
+
+export type ManifestHashAlgo = 'sha256' | 'xxh64'
+
+export interface ManifestOptions extends NativeIoOptions {
+    algo?: ManifestHashAlgo
+    exclude?: string[]
+    workers?: number
+}
+
+export interface ManifestFile {
+    path: string
+    size: number
+    mode: number
+    hash: string
+}
+
+export interface Manifest {
+    algo: ManifestHashAlgo
+    root: string
+    files: ManifestFile[]
+}
+
+export interface ManifestDiff {
+    equal: boolean
+    added: string[]
+    removed: string[]
+    changed: string[]
+    modeChanged: string[]
+}
+
 interface FileOperationsAddon {
-    watch(target: string, intervalMs: number, callback: (eventType: string, filename: string) => void): void
+    watch(target: string, intervalMs: number, callback: (eventType: string, filename: string) => void, options?: WatchOptions): () => void
     readFile(target: string): Buffer
     deleteFile(target: string): void
     renameFile(oldPath: string, newPath: string): void
     moveFile(src: string, dest: string): void
     fileExists(target: string): boolean
+    syncTree(src: string, dest: string, options?: SyncTreeOptions): Promise<SyncTreeResult>
+    openDir(root: string): NativeDirHandle
+    buildManifest(root: string, options?: ManifestOptions): Promise<Manifest>
+    diffManifest(a: Manifest, b: Manifest): ManifestDiff
+    readFileAsync(target: string, options?: NativeIoOptions): Promise<Buffer>
+    fileExistsAsync(target: string, options?: NativeIoOptions): Promise<boolean>
+    deleteFileAsync(target: string, options?: NativeIoOptions): Promise<void>
+    moveFileAsync(src: string, dest: string, options?: NativeIoOptions): Promise<void>
+    createCancelToken(timeoutMs?: number): NativeCancelToken
+    configureIoScheduler(config: NativeIoSchedulerConfig): void
+    getIoSchedulerStats(): NativeIoSchedulerStats
 }
 
 interface NativeModules {
@@ -63,6 +180,8 @@ const loadNativeModules = (): NativeModules => {
 
 const nativeModules = loadNativeModules()
 
+const isNativeCancelled = (err: unknown): boolean => (err as NodeJS.ErrnoException | undefined)?.code === 'ECANCELED'
+
 const handleSettingsFilenames = new Set([HANDLE_EVENTS_FILENAME.toLowerCase(), HANDLE_EVENTS_SETTINGS_FILENAME.toLowerCase()])
 
 const tryExtractAddonNameFromWatchPath = (filename: string): string | null => {
@@ -79,14 +198,17 @@ const tryExtractAddonNameFromWatchPath = (filename: string): string | null => {
     return parts[parts.length - 2] || null
 }
 
-export function startThemeWatcher(themesPath: string, intervalMs: number = 1000): void {
+let stopActiveThemeWatcher: (() => void) | null = null
+
+export function startThemeWatcher(themesPath: string, intervalMs: number = 1000, indexPath?: string): void {
     const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
     if (!addon) {
         logger.main.warn('fileOperations addon not loaded. startThemeWatcher will not watch files.')
         return
     }
+    stopThemeWatcher()
     logger.main.info(`Starting native watcher on ${themesPath} with interval ${intervalMs}ms`)
-    addon.watch(themesPath, intervalMs, (eventType, filename) => {
+    stopActiveThemeWatcher = addon.watch(themesPath, intervalMs, (eventType, filename) => {
         const watchedAddonName = tryExtractAddonNameFromWatchPath(filename)
         if (watchedAddonName) {
             sendAddonSettings({ addonName: watchedAddonName, force: true })
@@ -116,7 +238,18 @@ export function startThemeWatcher(themesPath: string, intervalMs: number = 1000)
             default:
                 logger.main.warn(`Unknown event ${eventType} on ${filename}`)
         }
-    })
+    }, indexPath ? { indexPath } : undefined)
+}
+
+export function stopThemeWatcher(): void {
+    if (!stopActiveThemeWatcher) return
+    const stop = stopActiveThemeWatcher
+    stopActiveThemeWatcher = null
+    try {
+        stop()
+    } catch (err) {
+        logger.nativeModuleManager.error(`Error stopping theme watcher: ${err}`)
+    }
 }
 
 export const nativeReadFile = (filePath: string): Buffer | null => {
@@ -192,4 +325,191 @@ export const nativeFileExists = (filePath: string): boolean => {
     }
 }
 
+export const nativeSyncTree = async (src: string, dest: string, options: SyncTreeOptions = {}): Promise<SyncTreeResult | null> => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeSyncTree will return null.')
+        return null
+    }
+    try {
+        return await addon.syncTree(src, dest, options)
+    } catch (err) {
+        if (isNativeCancelled(err)) {
+            logger.nativeModuleManager.info(`nativeSyncTree from '${src}' to '${dest}' was cancelled`)
+            return null
+        }
+        logger.nativeModuleManager.error(`Error in nativeSyncTree from '${src}' to '${dest}': ${err}`)
+        return null
+    }
+}
+
+export const nativeOpenDir = (root: string): NativeDirHandle | null => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeOpenDir will return null.')
+        return null
+    }
+    try {
+        return addon.openDir(root)
+    } catch (err) {
+        logger.nativeModuleManager.error(`Error in nativeOpenDir for '${root}': ${err}`)
+        return null
+    }
+}
+
+export const nativeBuildManifest = async (root: string, options: ManifestOptions = {}): Promise<Manifest | null> => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeBuildManifest will return null.')
+        return null
+    }
+    try {
+        return await addon.buildManifest(root, options)
+    } catch (err) {
+        if (isNativeCancelled(err)) {
+            logger.nativeModuleManager.info(`nativeBuildManifest for '${root}' was cancelled`)
+            return null
+        }
+        logger.nativeModuleManager.error(`Error in nativeBuildManifest for '${root}': ${err}`)
+        return null
+    }
+}
+
+export const nativeDiffManifest = (a: Manifest, b: Manifest): ManifestDiff | null => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeDiffManifest will return null.')
+        return null
+    }
+    try {
+        return addon.diffManifest(a, b)
+    } catch (err) {
+        logger.nativeModuleManager.error(`Error in nativeDiffManifest: ${err}`)
+        return null
+    }
+}
+
+export const nativeCreateCancelToken = (signal?: AbortSignal, timeoutMs?: number): NativeCancelToken | null => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeCreateCancelToken will return null.')
+        return null
+    }
+    try {
+        const token = addon.createCancelToken(timeoutMs)
+        if (signal?.aborted) {
+            token.cancel()
+        } else {
+            signal?.addEventListener('abort', () => token.cancel(), { once: true })
+        }
+        return token
+    } catch (err) {
+        logger.nativeModuleManager.error(`Error in nativeCreateCancelToken: ${err}`)
+        return null
+    }
+}
+
+export const nativeConfigureIoScheduler = (config: NativeIoSchedulerConfig): boolean => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeConfigureIoScheduler will be a no-op.')
+        return false
+    }
+    try {
+        addon.configureIoScheduler(config)
+        return true
+    } catch (err) {
+        logger.nativeModuleManager.error(`Error in nativeConfigureIoScheduler: ${err}`)
+        return false
+    }
+}
+
+export const nativeGetIoSchedulerStats = (): NativeIoSchedulerStats | null => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeGetIoSchedulerStats will return null.')
+        return null
+    }
+    try {
+        return addon.getIoSchedulerStats()
+    } catch (err) {
+        logger.nativeModuleManager.error(`Error in nativeGetIoSchedulerStats: ${err}`)
+        return null
+    }
+}
+
+export const nativeReadFileAsync = async (filePath: string, options: NativeIoOptions = {}): Promise<Buffer | null> => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeReadFileAsync will return null.')
+        return null
+    }
+    try {
+        return await addon.readFileAsync(filePath, options)
+    } catch (err) {
+        if (isNativeCancelled(err)) {
+            logger.nativeModuleManager.info(`nativeReadFileAsync for '${filePath}' was cancelled`)
+            return null
+        }
+        logger.nativeModuleManager.error(`Error in nativeReadFileAsync for '${filePath}': ${err}`)
+        return null
+    }
+}
+
+export const nativeFileExistsAsync = async (filePath: string, options: NativeIoOptions = {}): Promise<boolean> => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeFileExistsAsync will return false.')
+        return false
+    }
+    try {
+        return await addon.fileExistsAsync(filePath, options)
+    } catch (err) {
+        if (isNativeCancelled(err)) {
+            logger.nativeModuleManager.info(`nativeFileExistsAsync for '${filePath}' was cancelled`)
+            return false
+        }
+        logger.nativeModuleManager.error(`Error in nativeFileExistsAsync for '${filePath}': ${err}`)
+        return false
+    }
+}
+
+export const nativeDeleteFileAsync = async (filePath: string, options: NativeIoOptions = {}): Promise<boolean> => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeDeleteFileAsync will be a no-op.')
+        return false
+    }
+    try {
+        await addon.deleteFileAsync(filePath, options)
+        return true
+    } catch (err) {
+        if (isNativeCancelled(err)) {
+            logger.nativeModuleManager.info(`nativeDeleteFileAsync for '${filePath}' was cancelled`)
+            return false
+        }
+        logger.nativeModuleManager.error(`Error in nativeDeleteFileAsync for '${filePath}': ${err}`)
+        return false
+    }
+}
+
+export const nativeMoveFileAsync = async (src: string, dest: string, options: NativeIoOptions = {}): Promise<boolean> => {
+    const addon = nativeModules['fileOperations'] as FileOperationsAddon | undefined
+    if (!addon) {
+        logger.nativeModuleManager.warn('fileOperations addon not loaded. nativeMoveFileAsync will be a no-op.')
+        return false
+    }
+    try {
+        await addon.moveFileAsync(src, dest, options)
+        return true
+    } catch (err) {
+        if (isNativeCancelled(err)) {
+            logger.nativeModuleManager.info(`nativeMoveFileAsync from '${src}' to '${dest}' was cancelled`)
+            return false
+        }
+        logger.nativeModuleManager.error(`Error in nativeMoveFileAsync from '${src}' to '${dest}': ${err}`)
+        return false
+    }
+}
+
 export default nativeModules as NativeModules
@@ -10,6 +10,7 @@ import { getState } from './state'
 import { HandleErrorsElectron } from './handlers/handleErrorsElectron'
 import { computeAddonPackageHash, resolveAddonDirectoryKey, resolveAddonPublicationFingerprint, resolveAddonStableId } from '../utils/addonIdentity'
 import { findAddonByPublicationFingerprint } from '../utils/addonRegistry'
+import { nativeSyncTree } from './nativeModules'
 
 const State = getState()
 const SUPPORTED_ADDON_ARCHIVE_EXTENSIONS = new Set(['.pext', '.zip'])
@@ -110,14 +111,23 @@ export const importAddonArchive = async (rawPath: string, options: ImportAddonAr
                 preferStoreId: metadata.installSource === 'store',
             })
         const outputDir = path.join(app.getPath('userData'), 'addons', addonDirectory)
-        if (fs.existsSync(outputDir)) {
-            await clearDirectory(outputDir)
+        fs.writeFileSync(metadataPath, JSON.stringify(metadata, null, 4))
+
+        // Zip mtimes are coarse (and often fixed by the packer), so a same-size edit can keep
+        // its timestamp; compare contents instead of trusting (size, mtime).
+        const syncResult = await nativeSyncTree(tempDir, outputDir, { delete: true, verify: true })
+        if (syncResult) {
+            logger.main.info(`Addon directory synced: ${syncResult.copied} copied, ${syncResult.unchanged} unchanged, ${syncResult.deleted} deleted`)
         } else {
-            await fsp.mkdir(outputDir, { recursive: true })
-        }
+            if (fs.existsSync(outputDir)) {
+                await clearDirectory(outputDir)
+            } else {
+                await fsp.mkdir(outputDir, { recursive: true })
+            }
 
-        zip.extractAllTo(outputDir, true)
-        fs.writeFileSync(path.join(outputDir, 'metadata.json'), JSON.stringify(metadata, null, 4))
+            zip.extractAllTo(outputDir, true)
+            fs.writeFileSync(path.join(outputDir, 'metadata.json'), JSON.stringify(metadata, null, 4))
+        }
         logger.main.info(`Extension imported successfully from ${ext} archive to ${outputDir}`)
 
         if (ext === '.pext') {